@@ -0,0 +1,74 @@
+{SHADER_VERSION}
+{SHADER_TYPE}
+
+#ifdef TYPE_VERTEX
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in vec2 vertexUV;
+
+uniform mat4 modelViewProjection;
+uniform mat4 normalRotation;
+uniform mat4 localWorld;
+
+smooth out vec3 fragmentPosition;
+smooth out vec3 fragmentNormal;
+smooth out vec2 fragmentUV;
+
+void main() {
+    vec4 vertexWorldPosition = localWorld * vec4(vertexPosition, 1.0f);
+    vec4 vertexWorldNormal = normalRotation * vec4(vertexNormal, 1.0f);
+    gl_Position = modelViewProjection * vertexWorldPosition;
+
+    fragmentPosition = vec3(vertexWorldPosition);
+    fragmentNormal = vec3(vertexWorldNormal);
+    fragmentUV = vertexUV;
+}
+
+#endif
+
+#ifdef TYPE_FRAGMENT
+
+layout(std140) uniform Material {
+    float ambientIntensity;
+    float diffuseIntensity;
+    float specularIntensity;
+    int specularHardness;
+    vec3 diffuseColor;
+    bool hasDiffuseTexture;
+    vec3 specularColor;
+} material;
+
+uniform vec3 cameraPosition;
+uniform vec3 lightDirection;
+uniform vec3 lightColor;
+uniform float lightEnergy;
+uniform vec3 ambientColor;
+uniform float ambientEnergy;
+uniform sampler2D diffuseSampler;
+
+smooth in vec3 fragmentPosition;
+smooth in vec3 fragmentNormal;
+smooth in vec2 fragmentUV;
+
+layout(location = 0) out vec4 outputColor;
+
+// Single directed light and ambient term, matching deferred_lighting and ambient_lighting
+void main() {
+    vec3 diffuseSample = material.hasDiffuseTexture ? texture(diffuseSampler, fragmentUV).rgb : material.diffuseColor;
+    vec3 normal = normalize(fragmentNormal);
+    vec3 direction = normalize(lightDirection);
+
+    float luminance = dot(-direction, normal);
+    vec3 diffuseColor = diffuseSample * lightColor * (luminance > 0.0f ? luminance : 0.0f) * material.diffuseIntensity;
+
+    vec3 cameraDirection = normalize(fragmentPosition - cameraPosition);
+    vec3 reflectedDirection = reflect(direction, normal);
+    float highlight = pow(dot(-cameraDirection, reflectedDirection), float(material.specularHardness));
+    vec3 specularColor = material.specularColor * (highlight > 0.0f ? highlight : 0.0f) * material.specularIntensity;
+
+    vec3 ambient = diffuseSample * ambientColor * ambientEnergy * material.ambientIntensity;
+    outputColor = vec4(ambient + (diffuseColor + specularColor) * lightEnergy, 1.0f);
+}
+
+#endif
@@ -0,0 +1,75 @@
+{SHADER_VERSION}
+{SHADER_TYPE}
+
+#ifdef TYPE_VERTEX
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;   // Unused
+layout(location = 2) in vec2 vertexUV;
+
+smooth out vec2 fragmentUV;
+
+void main() {
+    gl_Position = vec4(vertexPosition, 1.0f);
+    fragmentUV = vertexUV;
+}
+
+#endif
+
+#ifdef TYPE_FRAGMENT
+
+#define EDGE_THRESHOLD     0.125f
+#define EDGE_THRESHOLD_MIN 0.0312f
+#define SPAN_MAX           8.0f
+#define REDUCE_MUL         0.125f
+#define REDUCE_MIN         0.0078125f
+
+uniform sampler2D diffuseSampler;
+
+smooth in vec2 fragmentUV;
+
+layout(location = 0) out vec4 outputColor;
+
+float luma(vec3 color) {
+    return dot(color, vec3(0.299f, 0.587f, 0.114f));
+}
+
+// FXAA over the lit image: blend along the local edge direction where the luma contrast is high
+void main() {
+    vec4 centerSample = texture(diffuseSampler, fragmentUV);
+    float lumaCenter = luma(centerSample.rgb);
+    float lumaNW = luma(textureOffset(diffuseSampler, fragmentUV, ivec2(-1, -1)).rgb);
+    float lumaNE = luma(textureOffset(diffuseSampler, fragmentUV, ivec2(1, -1)).rgb);
+    float lumaSW = luma(textureOffset(diffuseSampler, fragmentUV, ivec2(-1, 1)).rgb);
+    float lumaSE = luma(textureOffset(diffuseSampler, fragmentUV, ivec2(1, 1)).rgb);
+
+    float lumaMin = min(lumaCenter, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaCenter, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // Flat areas, most of the screen, take the single sample above
+    if (lumaMax - lumaMin < max(EDGE_THRESHOLD_MIN, lumaMax * EDGE_THRESHOLD)) {
+        outputColor = centerSample;
+        return;
+    }
+
+    vec2 direction = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float directionReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25f * REDUCE_MUL, REDUCE_MIN);
+    float directionScale = 1.0f / (min(abs(direction.x), abs(direction.y)) + directionReduce);
+
+    vec2 texelSize = 1.0f / vec2(textureSize(diffuseSampler, 0));
+    direction = clamp(direction * directionScale, -SPAN_MAX, SPAN_MAX) * texelSize;
+
+    vec3 innerColor = 0.5f * (
+        texture(diffuseSampler, fragmentUV + direction * (1.0f / 3.0f - 0.5f)).rgb +
+        texture(diffuseSampler, fragmentUV + direction * (2.0f / 3.0f - 0.5f)).rgb);
+    vec3 outerColor = innerColor * 0.5f + 0.25f * (
+        texture(diffuseSampler, fragmentUV - direction * 0.5f).rgb +
+        texture(diffuseSampler, fragmentUV + direction * 0.5f).rgb);
+
+    // The wider blend overshoots when it crosses another edge, fall back to the narrow one
+    float lumaOuter = luma(outerColor);
+    vec3 color = (lumaOuter < lumaMin || lumaOuter > lumaMax) ? innerColor : outerColor;
+    outputColor = vec4(color, centerSample.a);
+}
+
+#endif
@@ -71,8 +71,8 @@ bool ArgumentParser::addArgument(char name, const std::string& longName, const s
 }
 
 bool ArgumentParser::addArgument(const std::string& longName, const std::string& description, ValueType type) {
-    auto status = std::find_if_not(longName.begin(), longName.end(), [](char c) { return std::isalnum(c); });
-    if (status != longName.end()) {
+    auto status = std::find_if_not(longName.begin(), longName.end(), [](char c) { return std::isalnum(c) || c == '-'; });
+    if (longName.empty() || !std::isalnum(longName[0]) || status != longName.end()) {
         return false;
     }
 
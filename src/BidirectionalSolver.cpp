@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <BidirectionalSolver.h>
+#include <StateRank.h>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace Rubik {
+
+namespace {
+
+const int SHARDS = 256;
+const size_t INITIAL_SHARD_CAPACITY = 1024;    // Power of two
+const uint8_t NO_MOVE = 0xFF;
+const int NO_FACE = -1;
+
+uint64_t mix(const StateRank& rank) {
+    uint64_t value = rank.getEdges() * 0x9E3779B97F4A7C15ull + rank.getCorners();
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Turns of one face merge and turns of opposite faces commute, so only one order of them is tried
+bool isCanonical(int lastFace, int face) {
+    return lastFace == NO_FACE || (face != lastFace && !(face == (lastFace + 3) % 6 && face < lastFace));
+}
+
+void runParallel(int jobs, int threads, const std::function<void(int)>& job) {
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int index = next++; index < jobs; index = next++) {
+            job(index);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < std::min(jobs, threads); i++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+    for (auto& thread: workers) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+class BidirectionalSolver::Table {
+public:
+    struct Entry {
+        uint64_t edges;
+        uint32_t corners;   // UINT32_MAX for an empty slot
+        uint8_t depth;
+        uint8_t move;       // Leading to the state, NO_MOVE for the root
+    };
+
+    enum class Insert { ADDED, PRESENT, FULL };
+
+    Table(std::atomic<size_t>& memory, size_t memoryLimit):
+            shards(SHARDS),
+            memory(memory),
+            memoryLimit(memoryLimit) {
+    }
+
+    // Thread safe against other inserts
+    Insert insert(const StateRank& rank, int depth, int move) {
+        uint64_t hash = mix(rank);
+        Shard& shard = this->shards[hash >> 56];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // Keep the load under 3/4
+        if ((shard.size + 1) * 4 > shard.entries.size() * 3 && !this->grow(shard)) {
+            return Insert::FULL;
+        }
+
+        Entry& entry = this->probe(shard, hash, rank);
+        if (entry.corners != UINT32_MAX) {
+            return Insert::PRESENT;
+        }
+
+        entry = { rank.getEdges(), static_cast<uint32_t>(rank.getCorners()), static_cast<uint8_t>(depth), static_cast<uint8_t>(move) };
+        shard.size++;
+        return Insert::ADDED;
+    }
+
+    // Not synchronized, only while nothing is inserted
+    const Entry* find(const StateRank& rank) const {
+        uint64_t hash = mix(rank);
+        const Shard& shard = this->shards[hash >> 56];
+        if (shard.entries.empty()) {
+            return nullptr;
+        }
+
+        const Entry& entry = const_cast<Table*>(this)->probe(const_cast<Shard&>(shard), hash, rank);
+        return (entry.corners != UINT32_MAX) ? &entry : nullptr;
+    }
+
+    // Entries of one depth in a shard, thread safe against inserts
+    void collect(int shard, int depth, std::vector<Entry>& entries) {
+        std::lock_guard<std::mutex> lock(this->shards[shard].mutex);
+        entries.clear();
+        for (const Entry& entry: this->shards[shard].entries) {
+            if (entry.corners != UINT32_MAX && entry.depth == depth) {
+                entries.push_back(entry);
+            }
+        }
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        size_t size = 0;
+    };
+
+    Entry& probe(Shard& shard, uint64_t hash, const StateRank& rank) {
+        size_t mask = shard.entries.size() - 1;
+        for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+            Entry& entry = shard.entries[slot];
+            if (entry.corners == UINT32_MAX || (entry.corners == rank.getCorners() && entry.edges == rank.getEdges())) {
+                return entry;
+            }
+        }
+    }
+
+    bool grow(Shard& shard) {
+        size_t capacity = shard.entries.empty() ? INITIAL_SHARD_CAPACITY : shard.entries.size() * 2;
+        size_t added = (capacity - shard.entries.size()) * sizeof(Entry);
+        if (this->memory.fetch_add(added) + added > this->memoryLimit) {
+            this->memory -= added;
+            return false;
+        }
+
+        std::vector<Entry> entries(capacity, Entry { 0, UINT32_MAX, 0, NO_MOVE });
+        entries.swap(shard.entries);
+
+        for (const Entry& entry: entries) {
+            if (entry.corners != UINT32_MAX) {
+                StateRank rank(entry.corners, entry.edges);
+                this->probe(shard, mix(rank), rank) = entry;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<Shard> shards;
+    std::atomic<size_t>& memory;
+    size_t memoryLimit;
+};
+
+BidirectionalSolver::BidirectionalSolver():
+        threads(std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+size_t BidirectionalSolver::getMemory() const {
+    return this->memory;
+}
+
+void BidirectionalSolver::setMemory(size_t memory) {
+    this->memory = memory;
+}
+
+int BidirectionalSolver::getThreads() const {
+    return this->threads;
+}
+
+void BidirectionalSolver::setThreads(int threads) {
+    this->threads = std::max(1, threads);
+}
+
+uint64_t BidirectionalSolver::getNodes() const {
+    return this->nodes;
+}
+
+bool BidirectionalSolver::solve(const CubeState& state, int maxLength, std::vector<Move>& solution) {
+    this->nodes = 0;
+    solution.clear();
+    if (state.isSolved()) {
+        return true;
+    }
+
+    // Side 0 grows from the position, side 1 from the solved cube
+    std::atomic<size_t> memory(0);
+    Table tables[2] = { Table(memory, this->memory), Table(memory, this->memory) };
+    tables[0].insert(StateRank(state), 0, NO_MOVE);
+    tables[1].insert(StateRank(CubeState()), 0, NO_MOVE);
+
+    int depths[2] = { 0, 0 };
+    uint64_t frontiers[2] = { 1, 1 };
+
+    while (depths[0] + depths[1] < maxLength) {
+        int side = (frontiers[0] <= frontiers[1]) ? 0 : 1;
+        Table& table = tables[side];
+        const Table& other = tables[1 - side];
+        int depth = depths[side];
+
+        std::atomic<uint64_t> added(0);
+        std::atomic<uint64_t> generated(0);
+        std::atomic<bool> isFull(false);
+
+        // Shortest meeting of this level, all shorter paths were ruled out by the levels before
+        std::mutex meetingMutex;
+        int meetingLength = maxLength + 1;
+        StateRank meeting;
+
+        runParallel(SHARDS, this->threads, [&](int shard) {
+            std::vector<Table::Entry> entries;
+            table.collect(shard, depth, entries);
+
+            uint64_t shardAdded = 0;
+            uint64_t shardGenerated = 0;
+            for (const Table::Entry& entry: entries) {
+                if (isFull) {
+                    break;
+                }
+
+                CubeState parent(StateRank(entry.corners, entry.edges).getState());
+                int lastFace = (entry.move == NO_MOVE) ? NO_FACE : entry.move / 3;
+
+                for (int move = 0; move < CubeState::MOVES; move++) {
+                    if (!isCanonical(lastFace, move / 3)) {
+                        continue;
+                    }
+
+                    CubeState child(parent);
+                    child.applyMove(static_cast<Move>(move));
+                    StateRank rank(child);
+                    shardGenerated++;
+
+                    Table::Insert result = table.insert(rank, depth + 1, move);
+                    if (result == Table::Insert::FULL) {
+                        isFull = true;
+                        break;
+                    }
+
+                    if (result == Table::Insert::ADDED) {
+                        shardAdded++;
+
+                        const Table::Entry* match = other.find(rank);
+                        if (match != nullptr) {
+                            std::lock_guard<std::mutex> lock(meetingMutex);
+                            if (depth + 1 + match->depth < meetingLength) {
+                                meetingLength = depth + 1 + match->depth;
+                                meeting = rank;
+                            }
+                        }
+                    }
+                }
+            }
+
+            added += shardAdded;
+            generated += shardGenerated;
+        });
+
+        this->nodes += generated;
+        depths[side]++;
+        frontiers[side] = added;
+
+        if (meetingLength <= maxLength) {
+            // Walk both paths back from the meeting state, the one from the solved cube reversed
+            std::vector<Move> paths[2];
+            for (int path = 0; path < 2; path++) {
+                StateRank rank(meeting);
+                for (const Table::Entry* entry = tables[path].find(rank); entry->move != NO_MOVE; entry = tables[path].find(rank)) {
+                    paths[path].push_back(static_cast<Move>(entry->move));
+                    CubeState parent(rank.getState());
+                    parent.applyMove(InverseMove(static_cast<Move>(entry->move)));
+                    rank = StateRank(parent);
+                }
+            }
+
+            solution.assign(paths[0].rbegin(), paths[0].rend());
+            for (Move move: paths[1]) {
+                solution.push_back(InverseMove(move));
+            }
+
+            return true;
+        }
+
+        if (isFull || added == 0) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace Rubik
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BIDIRECTIONALSOLVER_H
+#define BIDIRECTIONALSOLVER_H
+
+#include <CubeState.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Rubik {
+
+// Optimal solver for short positions. Two breadth-first searches, one from the position and one
+// from the solved cube, grow a level at a time on whichever side has the smaller frontier until a
+// new state turns up in the other side's set. Sets are open addressing tables of ranked states;
+// each entry keeps its depth and the move leading to it, so the path is walked back from where
+// the searches meet. Tables grow up to the memory limit and every level is expanded by all threads.
+class BidirectionalSolver {
+public:
+    static const size_t DEFAULT_MEMORY = static_cast<size_t>(1024) << 20;
+
+    BidirectionalSolver();
+
+    size_t getMemory() const;
+    void setMemory(size_t memory);
+
+    int getThreads() const;
+    void setThreads(int threads);
+
+    // States generated by the last solve
+    uint64_t getNodes() const;
+
+    // False if there is no solution within maxLength or the memory runs out first
+    bool solve(const CubeState& state, int maxLength, std::vector<Move>& solution);
+
+private:
+    class Table;
+
+    size_t memory = DEFAULT_MEMORY;
+    int threads;
+    uint64_t nodes = 0;
+};
+
+}  // namespace Rubik
+
+#endif  // BIDIRECTIONALSOLVER_H
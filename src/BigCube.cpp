@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <BigCube.h>
+#include <unordered_map>
+#include <stdexcept>
+#include <mutex>
+
+namespace Rubik {
+
+namespace {
+
+typedef std::array<int, 3> Vector;
+
+const Vector faceNormals[6] = {
+    {{ 0,  1,  0 }}, {{ 1,  0,  0 }}, {{ 0,  0,  1 }},  // U, R, F
+    {{ 0, -1,  0 }}, {{ -1, 0,  0 }}, {{ 0,  0, -1 }}   // D, L, B
+};
+
+const char faceNames[] = "URFDLB";
+
+// Quarter turn clockwise looking at the face, i.e. -90 degrees around its normal
+Vector rotate(const Vector& vector, const Vector& axis) {
+    int dot = axis[0] * vector[0] + axis[1] * vector[1] + axis[2] * vector[2];
+    Vector cross = {{
+        axis[1] * vector[2] - axis[2] * vector[1],
+        axis[2] * vector[0] - axis[0] * vector[2],
+        axis[0] * vector[1] - axis[1] * vector[0]
+    }};
+
+    return {{ axis[0] * dot - cross[0], axis[1] * dot - cross[1], axis[2] * dot - cross[2] }};
+}
+
+// Cubie under a facelet of the net, rows go top to bottom and columns left to right
+Vector netCubie(Face face, int row, int column, int size) {
+    int last = size - 1;
+
+    switch (face) {
+        case Face::U: return {{ column, last, row }};
+        case Face::R: return {{ last, last - row, last - column }};
+        case Face::F: return {{ column, last - row, last }};
+        case Face::D: return {{ column, 0, last - row }};
+        case Face::L: return {{ 0, last - row, column }};
+        default:      return {{ last - column, last - row, 0 }};
+    }
+}
+
+}  // namespace
+
+LayerMove InverseLayerMove(const LayerMove& move) {
+    return { move.axis, move.layer, static_cast<uint8_t>(4 - move.turns) };
+}
+
+// Outer layers are named by their face, inner ones by the layer number from the nearer face
+std::string LayerMoveName(int size, const LayerMove& move) {
+    static const char positive[] = "RUF";
+    static const char negative[] = "LDB";
+
+    int layer = move.layer;
+    int turns = move.turns;
+    char face = positive[move.axis];
+
+    if (layer >= size - 1 - layer) {
+        layer = size - 1 - layer;
+        turns = 4 - turns;
+        face = negative[move.axis];
+    }
+
+    std::string name;
+    if (layer > 0) {
+        name += std::to_string(layer + 1);
+    }
+
+    name += face;
+    if (turns == 2) {
+        name += '2';
+    } else if (turns == 3) {
+        name += '\'';
+    }
+
+    return name;
+}
+
+class BigCube::Geometry {
+public:
+    explicit Geometry(int size):
+            size(size) {
+        int facelets = 6 * size * size;
+        this->faces.resize(facelets);
+        this->cubies.resize(facelets);
+
+        std::unordered_map<int, int> points;
+        std::vector<Vector> positions(facelets);
+
+        for (int facelet = 0; facelet < facelets; facelet++) {
+            Face face = static_cast<Face>(facelet / (size * size));
+            Vector cubie = netCubie(face, facelet / size % size, facelet % size, size);
+            const Vector& normal = faceNormals[static_cast<int>(face)];
+
+            // Doubled coordinates centered on the cube, facelets sit one unit off their cubie
+            for (int i = 0; i < 3; i++) {
+                positions[facelet][i] = 2 * cubie[i] - (size - 1) + normal[i];
+            }
+
+            this->faces[facelet] = face;
+            this->cubies[facelet] = cubie;
+            points[this->encode(positions[facelet])] = facelet;
+        }
+
+        static const Face axisFaces[3] = { Face::R, Face::U, Face::F };
+        this->turns.resize(3 * size);
+
+        for (int axis = 0; axis < 3; axis++) {
+            const Vector& normal = faceNormals[static_cast<int>(axisFaces[axis])];
+
+            for (int layer = 0; layer < size; layer++) {
+                std::vector<uint16_t>& turn = this->turns[axis * size + layer];
+                turn.resize(facelets);
+
+                for (int facelet = 0; facelet < facelets; facelet++) {
+                    bool turned = (this->cubies[facelet][axis] == size - 1 - layer);
+                    int target = turned ? points.at(this->encode(rotate(positions[facelet], normal))) : facelet;
+                    turn[facelet] = static_cast<uint16_t>(target);
+                }
+            }
+        }
+    }
+
+    int encode(const Vector& position) const {
+        int span = 2 * this->size + 1;
+        return ((position[0] + this->size) * span + position[1] + this->size) * span + position[2] + this->size;
+    }
+
+    int size;
+    std::vector<Face> faces;
+    std::vector<Vector> cubies;
+    std::vector<std::vector<uint16_t>> turns;
+};
+
+BigCube::BigCube(int size) {
+    if (size < BigCube::MIN_SIZE || size > BigCube::MAX_SIZE) {
+        throw std::invalid_argument("BigCube(): unsupported size");
+    }
+
+    // Geometry only depends on the size, cubes of one size share it
+    static std::unordered_map<int, std::shared_ptr<const Geometry>> geometries;
+    static std::mutex geometriesMutex;
+
+    {
+        std::lock_guard<std::mutex> lock(geometriesMutex);
+        auto& geometry = geometries[size];
+        if (!geometry) {
+            geometry = std::make_shared<Geometry>(size);
+        }
+
+        this->geometry = geometry;
+    }
+
+    this->facelets.resize(6 * size * size);
+    for (size_t facelet = 0; facelet < this->facelets.size(); facelet++) {
+        this->facelets[facelet] = static_cast<uint8_t>(facelet / (size * size));
+    }
+}
+
+int BigCube::getSize() const {
+    return this->geometry->size;
+}
+
+int BigCube::getFacelets() const {
+    return static_cast<int>(this->facelets.size());
+}
+
+Face BigCube::getFacelet(int facelet) const {
+    return static_cast<Face>(this->facelets.at(facelet));
+}
+
+void BigCube::setFacelet(int facelet, Face face) {
+    this->facelets.at(facelet) = static_cast<uint8_t>(face);
+}
+
+Face BigCube::getFaceletFace(int facelet) const {
+    return this->geometry->faces.at(facelet);
+}
+
+std::array<int, 3> BigCube::getFaceletCubie(int facelet) const {
+    return this->geometry->cubies.at(facelet);
+}
+
+int BigCube::findFacelet(Face face, int x, int y, int z) const {
+    int size = this->geometry->size;
+
+    for (int facelet = static_cast<int>(face) * size * size; facelet < (static_cast<int>(face) + 1) * size * size; facelet++) {
+        const Vector& cubie = this->geometry->cubies[facelet];
+        if (cubie[0] == x && cubie[1] == y && cubie[2] == z) {
+            return facelet;
+        }
+    }
+
+    return -1;
+}
+
+const std::vector<uint16_t>& BigCube::getTurn(int axis, int layer) const {
+    return this->geometry->turns.at(axis * this->geometry->size + layer);
+}
+
+void BigCube::applyMove(const LayerMove& move) {
+    const std::vector<uint16_t>& turn = this->getTurn(move.axis, move.layer);
+    this->buffer.resize(this->facelets.size());
+
+    for (int i = 0; i < move.turns; i++) {
+        for (size_t facelet = 0; facelet < this->facelets.size(); facelet++) {
+            this->buffer[turn[facelet]] = this->facelets[facelet];
+        }
+
+        this->facelets.swap(this->buffer);
+    }
+}
+
+void BigCube::applyMoves(const std::vector<LayerMove>& moves) {
+    for (auto& move: moves) {
+        this->applyMove(move);
+    }
+}
+
+bool BigCube::isSolved() const {
+    int faceSize = this->geometry->size * this->geometry->size;
+
+    for (size_t facelet = 0; facelet < this->facelets.size(); facelet++) {
+        if (this->facelets[facelet] != this->facelets[facelet - facelet % faceSize]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string BigCube::toString() const {
+    std::string facelets;
+    facelets.reserve(this->facelets.size());
+
+    for (uint8_t face: this->facelets) {
+        facelets += faceNames[face];
+    }
+
+    return facelets;
+}
+
+}  // namespace Rubik
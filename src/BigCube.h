@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BIGCUBE_H
+#define BIGCUBE_H
+
+#include <CubeState.h>
+#include <vector>
+#include <string>
+#include <memory>
+#include <array>
+#include <cstdint>
+
+namespace Rubik {
+
+// Turn of a single layer. Axes point to R, U and F, layers are counted from that side, so layer 0
+// of axis 0 is the R face and layer size - 1 is the L face. Turns are clockwise looking from R, U or F.
+struct LayerMove {
+    uint8_t axis;
+    uint8_t layer;
+    uint8_t turns;
+};
+
+LayerMove InverseLayerMove(const LayerMove& move);
+std::string LayerMoveName(int size, const LayerMove& move);
+
+// Facelet level state of an NxN cube. Facelets go face by face in the U, R, F, D, L, B order, row by
+// row as the faces are laid out in the usual net, every facelet holding the face it belongs to.
+class BigCube {
+public:
+    static const int MIN_SIZE = 2;
+    static const int MAX_SIZE = 32;
+
+    explicit BigCube(int size);
+
+    int getSize() const;
+    int getFacelets() const;
+
+    Face getFacelet(int facelet) const;
+    void setFacelet(int facelet, Face face);
+
+    // Where the facelet is: its face and the cubie coordinates, x to R, y to U and z to F
+    Face getFaceletFace(int facelet) const;
+    std::array<int, 3> getFaceletCubie(int facelet) const;
+    int findFacelet(Face face, int x, int y, int z) const;
+
+    // Quarter turn of a layer, facelet i goes to getTurn()[i]
+    const std::vector<uint16_t>& getTurn(int axis, int layer) const;
+
+    void applyMove(const LayerMove& move);
+    void applyMoves(const std::vector<LayerMove>& moves);
+
+    bool isSolved() const;
+    std::string toString() const;
+
+private:
+    class Geometry;
+
+    std::shared_ptr<const Geometry> geometry;
+    std::vector<uint8_t> facelets;
+    std::vector<uint8_t> buffer;
+};
+
+}  // namespace Rubik
+
+#endif  // BIGCUBE_H
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <CubeState.h>
+#include <Random.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Rubik {
+
+namespace {
+
+typedef std::array<int, 3> Vector;
+
+const Vector faceNormals[6] = {
+    {{ 0,  1,  0 }}, {{ 1,  0,  0 }}, {{ 0,  0,  1 }},  // U, R, F
+    {{ 0, -1,  0 }}, {{ -1, 0,  0 }}, {{ 0,  0, -1 }}   // D, L, B
+};
+
+// Facelets of every slot, the reference facelet goes first and the rest follow clockwise
+const Face cornerFacelets[CubeState::CORNERS][3] = {
+    { Face::U, Face::R, Face::F }, { Face::U, Face::F, Face::L }, { Face::U, Face::L, Face::B }, { Face::U, Face::B, Face::R },
+    { Face::D, Face::F, Face::R }, { Face::D, Face::L, Face::F }, { Face::D, Face::B, Face::L }, { Face::D, Face::R, Face::B }
+};
+
+const Face edgeFacelets[CubeState::EDGES][2] = {
+    { Face::U, Face::R }, { Face::U, Face::F }, { Face::U, Face::L }, { Face::U, Face::B },
+    { Face::D, Face::R }, { Face::D, Face::F }, { Face::D, Face::L }, { Face::D, Face::B },
+    { Face::F, Face::R }, { Face::F, Face::L }, { Face::B, Face::L }, { Face::B, Face::R }
+};
+
+const char* moveNames[CubeState::MOVES] = {
+    "U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'", "D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'"
+};
+
+const Vector& normal(Face face) {
+    return faceNormals[static_cast<int>(face)];
+}
+
+template<size_t N>
+Vector position(const Face (&facelets)[N]) {
+    Vector position = {{ 0, 0, 0 }};
+    for (Face face: facelets) {
+        for (int i = 0; i < 3; i++) {
+            position[i] += normal(face)[i];
+        }
+    }
+
+    return position;
+}
+
+// Quarter turn clockwise looking at the face, i.e. -90 degrees around its normal
+Vector rotate(const Vector& vector, const Vector& axis) {
+    int dot = axis[0] * vector[0] + axis[1] * vector[1] + axis[2] * vector[2];
+    Vector cross = {{
+        axis[1] * vector[2] - axis[2] * vector[1],
+        axis[2] * vector[0] - axis[0] * vector[2],
+        axis[0] * vector[1] - axis[1] * vector[0]
+    }};
+
+    return {{ axis[0] * dot - cross[0], axis[1] * dot - cross[1], axis[2] * dot - cross[2] }};
+}
+
+template<size_t S, size_t N>
+void turnSlots(const Face (&facelets)[S][N], const Vector& axis, uint8_t* permutation, uint8_t* orientation) {
+    for (size_t slot = 0; slot < S; slot++) {
+        Vector from = position(facelets[slot]);
+        if (from[0] * axis[0] + from[1] * axis[1] + from[2] * axis[2] != 1) {
+            permutation[slot] = static_cast<uint8_t>(slot);
+            orientation[slot] = 0;
+            continue;
+        }
+
+        Vector to = rotate(from, axis);
+        Vector reference = rotate(normal(facelets[slot][0]), axis);
+
+        for (size_t target = 0; target < S; target++) {
+            if (position(facelets[target]) == to) {
+                for (size_t facelet = 0; facelet < N; facelet++) {
+                    if (normal(facelets[target][facelet]) == reference) {
+                        permutation[target] = static_cast<uint8_t>(slot);
+                        orientation[target] = static_cast<uint8_t>(facelet);
+                    }
+                }
+            }
+        }
+    }
+}
+
+class MoveTable {
+public:
+    MoveTable() {
+        for (int face = 0; face < 6; face++) {
+            CubeState turn;
+            uint8_t corners[CubeState::CORNERS], cornerOrientations[CubeState::CORNERS];
+            uint8_t edges[CubeState::EDGES], edgeOrientations[CubeState::EDGES];
+
+            turnSlots(cornerFacelets, faceNormals[face], corners, cornerOrientations);
+            turnSlots(edgeFacelets, faceNormals[face], edges, edgeOrientations);
+
+            for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+                turn.setCorner(slot, corners[slot], cornerOrientations[slot]);
+            }
+
+            for (int slot = 0; slot < CubeState::EDGES; slot++) {
+                turn.setEdge(slot, edges[slot], edgeOrientations[slot]);
+            }
+
+            this->moves[face * 3] = turn;
+            this->moves[face * 3 + 1] = this->moves[face * 3].multiply(turn);
+            this->moves[face * 3 + 2] = this->moves[face * 3 + 1].multiply(turn);
+        }
+    }
+
+    const CubeState& get(Move move) const {
+        return this->moves[static_cast<int>(move)];
+    }
+
+private:
+    CubeState moves[CubeState::MOVES];
+};
+
+const MoveTable& getMoveTable() {
+    static const MoveTable moveTable;
+    return moveTable;
+}
+
+template<size_t N>
+int parity(const std::array<uint8_t, N>& permutation) {
+    int parity = 0;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = i + 1; j < N; j++) {
+            parity ^= (permutation[i] > permutation[j]) ? 1 : 0;
+        }
+    }
+
+    return parity;
+}
+
+template<size_t N>
+bool isPermutation(const std::array<uint8_t, N>& permutation) {
+    std::array<bool, N> seen = {};
+    for (uint8_t value: permutation) {
+        if (value >= N || seen[value]) {
+            return false;
+        }
+
+        seen[value] = true;
+    }
+
+    return true;
+}
+
+template<size_t N>
+void shuffle(std::array<uint8_t, N>& permutation, Random& random) {
+    for (size_t i = N - 1; i > 0; i--) {
+        std::swap(permutation[i], permutation[random.uniform(static_cast<uint32_t>(i + 1))]);
+    }
+}
+
+}  // namespace
+
+Face MoveFace(Move move) {
+    return static_cast<Face>(static_cast<int>(move) / 3);
+}
+
+int MoveTurns(Move move) {
+    return static_cast<int>(move) % 3 + 1;
+}
+
+Move InverseMove(Move move) {
+    int index = static_cast<int>(move);
+    return static_cast<Move>(index - index % 3 + 2 - index % 3);
+}
+
+const char* MoveName(Move move) {
+    return moveNames[static_cast<int>(move)];
+}
+
+bool ParseMove(const std::string& name, Move& move) {
+    for (int i = 0; i < CubeState::MOVES; i++) {
+        if (name == moveNames[i]) {
+            move = static_cast<Move>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+CubeState::CubeState() {
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        this->corners[i] = static_cast<uint8_t>(i);
+        this->cornerOrientations[i] = 0;
+    }
+
+    for (int i = 0; i < CubeState::EDGES; i++) {
+        this->edges[i] = static_cast<uint8_t>(i);
+        this->edgeOrientations[i] = 0;
+    }
+}
+
+CubeState CubeState::random(Random& random) {
+    CubeState state;
+    shuffle(state.corners, random);
+    shuffle(state.edges, random);
+
+    // Odd edge permutations are matched one to one with even ones, which keeps the draw uniform
+    if (parity(state.corners) != parity(state.edges)) {
+        std::swap(state.edges[CubeState::EDGES - 2], state.edges[CubeState::EDGES - 1]);
+    }
+
+    int twist = 0;
+    for (int i = 0; i < CubeState::CORNERS - 1; i++) {
+        state.cornerOrientations[i] = static_cast<uint8_t>(random.uniform(3));
+        twist += state.cornerOrientations[i];
+    }
+
+    int flip = 0;
+    for (int i = 0; i < CubeState::EDGES - 1; i++) {
+        state.edgeOrientations[i] = static_cast<uint8_t>(random.uniform(2));
+        flip += state.edgeOrientations[i];
+    }
+
+    state.cornerOrientations[CubeState::CORNERS - 1] = static_cast<uint8_t>((3 - twist % 3) % 3);
+    state.edgeOrientations[CubeState::EDGES - 1] = static_cast<uint8_t>(flip % 2);
+
+    return state;
+}
+
+Face CubeState::getCornerFacelet(int slot, int facelet) {
+    return cornerFacelets[slot][facelet];
+}
+
+Face CubeState::getEdgeFacelet(int slot, int facelet) {
+    return edgeFacelets[slot][facelet];
+}
+
+int CubeState::getCorner(int slot) const {
+    return this->corners[slot];
+}
+
+int CubeState::getCornerOrientation(int slot) const {
+    return this->cornerOrientations[slot];
+}
+
+void CubeState::setCorner(int slot, int corner, int orientation) {
+    if (slot < 0 || slot >= CubeState::CORNERS || corner < 0 || corner >= CubeState::CORNERS || orientation < 0 || orientation > 2) {
+        throw std::out_of_range("setCorner(): invalid corner");
+    }
+
+    this->corners[slot] = static_cast<uint8_t>(corner);
+    this->cornerOrientations[slot] = static_cast<uint8_t>(orientation);
+}
+
+int CubeState::getEdge(int slot) const {
+    return this->edges[slot];
+}
+
+int CubeState::getEdgeOrientation(int slot) const {
+    return this->edgeOrientations[slot];
+}
+
+void CubeState::setEdge(int slot, int edge, int orientation) {
+    if (slot < 0 || slot >= CubeState::EDGES || edge < 0 || edge >= CubeState::EDGES || orientation < 0 || orientation > 1) {
+        throw std::out_of_range("setEdge(): invalid edge");
+    }
+
+    this->edges[slot] = static_cast<uint8_t>(edge);
+    this->edgeOrientations[slot] = static_cast<uint8_t>(orientation);
+}
+
+void CubeState::applyMove(Move move) {
+    *this = this->multiply(getMoveTable().get(move));
+}
+
+void CubeState::applyMoves(const std::vector<Move>& moves) {
+    for (Move move: moves) {
+        this->applyMove(move);
+    }
+}
+
+CubeState CubeState::multiply(const CubeState& other) const {
+    CubeState product;
+
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        int corner = other.corners[i];
+        product.corners[i] = this->corners[corner];
+        product.cornerOrientations[i] = static_cast<uint8_t>((this->cornerOrientations[corner] + other.cornerOrientations[i]) % 3);
+    }
+
+    for (int i = 0; i < CubeState::EDGES; i++) {
+        int edge = other.edges[i];
+        product.edges[i] = this->edges[edge];
+        product.edgeOrientations[i] = static_cast<uint8_t>((this->edgeOrientations[edge] + other.edgeOrientations[i]) % 2);
+    }
+
+    return product;
+}
+
+CubeState CubeState::inverse() const {
+    CubeState inverse;
+
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        int corner = this->corners[i];
+        inverse.corners[corner] = static_cast<uint8_t>(i);
+        inverse.cornerOrientations[corner] = static_cast<uint8_t>((3 - this->cornerOrientations[i]) % 3);
+    }
+
+    for (int i = 0; i < CubeState::EDGES; i++) {
+        int edge = this->edges[i];
+        inverse.edges[edge] = static_cast<uint8_t>(i);
+        inverse.edgeOrientations[edge] = this->edgeOrientations[i];
+    }
+
+    return inverse;
+}
+
+bool CubeState::isSolved() const {
+    return (*this == CubeState());
+}
+
+bool CubeState::isValid() const {
+    if (!isPermutation(this->corners) || !isPermutation(this->edges)) {
+        return false;
+    }
+
+    int twist = 0;
+    for (uint8_t orientation: this->cornerOrientations) {
+        twist += orientation;
+    }
+
+    int flip = 0;
+    for (uint8_t orientation: this->edgeOrientations) {
+        flip += orientation;
+    }
+
+    return (twist % 3 == 0 && flip % 2 == 0 && this->getCornerParity() == this->getEdgeParity());
+}
+
+int CubeState::getCornerParity() const {
+    return parity(this->corners);
+}
+
+int CubeState::getEdgeParity() const {
+    return parity(this->edges);
+}
+
+bool CubeState::operator==(const CubeState& other) const {
+    return (this->corners == other.corners && this->cornerOrientations == other.cornerOrientations &&
+            this->edges == other.edges && this->edgeOrientations == other.edgeOrientations);
+}
+
+bool CubeState::operator!=(const CubeState& other) const {
+    return !(*this == other);
+}
+
+}  // namespace Rubik
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CUBESTATE_H
+#define CUBESTATE_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace Rubik {
+
+enum class Face { U, R, F, D, L, B };
+
+// Face turns in the standard notation, quarter turn clockwise first
+enum class Move { U, U2, U3, R, R2, R3, F, F2, F3, D, D2, D3, L, L2, L3, B, B2, B3 };
+
+Face MoveFace(Move move);
+int MoveTurns(Move move);
+Move InverseMove(Move move);
+const char* MoveName(Move move);
+bool ParseMove(const std::string& name, Move& move);
+
+class Random;
+
+// Cubie level state: which cubie occupies every corner and edge slot and how it is twisted or flipped.
+// Slots follow the usual URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB and UR, UF, UL, UB, DR, DF, DL, DB,
+// FR, FL, BL, BR order, orientation is counted clockwise from the U/D (or F/B for E slice edges) facelet.
+class CubeState {
+public:
+    static const int CORNERS = 8;
+    static const int EDGES = 12;
+    static const int MOVES = 18;
+
+    CubeState();
+
+    static CubeState random(Random& random);
+
+    static Face getCornerFacelet(int slot, int facelet);
+    static Face getEdgeFacelet(int slot, int facelet);
+
+    int getCorner(int slot) const;
+    int getCornerOrientation(int slot) const;
+    void setCorner(int slot, int corner, int orientation);
+
+    int getEdge(int slot) const;
+    int getEdgeOrientation(int slot) const;
+    void setEdge(int slot, int edge, int orientation);
+
+    void applyMove(Move move);
+    void applyMoves(const std::vector<Move>& moves);
+
+    CubeState multiply(const CubeState& other) const;
+    CubeState inverse() const;
+
+    bool isSolved() const;
+    bool isValid() const;
+
+    int getCornerParity() const;
+    int getEdgeParity() const;
+
+    bool operator==(const CubeState& other) const;
+    bool operator!=(const CubeState& other) const;
+
+private:
+    friend class Notation;  // Fills parsed states without the range checks of the setters
+
+    std::array<uint8_t, CORNERS> corners;
+    std::array<uint8_t, CORNERS> cornerOrientations;
+    std::array<uint8_t, EDGES> edges;
+    std::array<uint8_t, EDGES> edgeOrientations;
+};
+
+}  // namespace Rubik
+
+#endif  // CUBESTATE_H
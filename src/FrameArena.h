@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <memory>
+#include <new>
+#include <cstddef>
+
+namespace Rubik {
+
+// Scratch memory that lives until the end of a frame. One block is allocated up front and handed
+// out by bumping an offset, reset() at the start of a frame makes all of it available again.
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity);
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Uninitialized, throws std::bad_alloc rather than falling back to the heap
+    template<typename T>
+    T* allocate(size_t count) {
+        size_t offset = (this->used + alignof(T) - 1) / alignof(T) * alignof(T);
+        if (offset + count * sizeof(T) > this->capacity) {
+            throw std::bad_alloc();
+        }
+
+        this->used = offset + count * sizeof(T);
+        return reinterpret_cast<T*>(this->memory.get() + offset);
+    }
+
+    void reset();
+
+    size_t getCapacity() const;
+    size_t getUsed() const;
+
+private:
+    std::unique_ptr<unsigned char[]> memory;
+    size_t capacity;
+    size_t used = 0;
+};
+
+}  // namespace Rubik
+
+#endif  // FRAMEARENA_H
@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Notation.h>
+#include <algorithm>
+#include <iterator>
+#include <bitset>
+#include <cstring>
+#include <cstdint>
+
+namespace Rubik {
+
+namespace {
+
+// Whole cube quarter turns, each face position takes the face from the position before it
+const Face rotationCycles[3][4] = {
+    { Face::U, Face::F, Face::D, Face::B },    // x
+    { Face::F, Face::R, Face::B, Face::L },    // y
+    { Face::U, Face::L, Face::D, Face::R }     // z
+};
+
+// Facelet string positions of every slot, in CubeState facelet order
+const int cornerFacelets[CubeState::CORNERS][3] = {
+    { 8, 9, 20 }, { 6, 18, 38 }, { 0, 36, 47 }, { 2, 45, 11 },
+    { 29, 26, 15 }, { 27, 44, 24 }, { 33, 53, 42 }, { 35, 17, 51 }
+};
+
+const int edgeFacelets[CubeState::EDGES][2] = {
+    { 5, 10 }, { 7, 19 }, { 3, 37 }, { 1, 46 }, { 32, 16 }, { 28, 25 },
+    { 30, 43 }, { 34, 52 }, { 23, 12 }, { 21, 41 }, { 50, 39 }, { 48, 14 }
+};
+
+const char faceNames[6] = { 'U', 'R', 'F', 'D', 'L', 'B' };
+
+const char* errorNames[] = {
+    "none", "unknown move", "too long", "unknown facelet", "misplaced center",
+    "impossible cubie", "twisted corner", "flipped edge", "odd permutation"
+};
+
+// Lookups for parsing facelets: the face of every character and the cubie of every pair of colors
+class CubieTable {
+public:
+    CubieTable() {
+        std::fill(std::begin(this->faces), std::end(this->faces), -1);
+        std::fill(std::begin(this->corners), std::end(this->corners), -1);
+        std::fill(std::begin(this->edges), std::end(this->edges), -1);
+
+        for (int face = 0; face < 6; face++) {
+            this->faces[static_cast<unsigned char>(faceNames[face])] = static_cast<int8_t>(face);
+        }
+
+        // Cubies by their facelets in slot order, in every orientation
+        for (int corner = 0; corner < CubeState::CORNERS; corner++) {
+            for (int twist = 0; twist < 3; twist++) {
+                int first = static_cast<int>(CubeState::getCornerFacelet(corner, (3 - twist) % 3));
+                int second = static_cast<int>(CubeState::getCornerFacelet(corner, (4 - twist) % 3));
+                int third = static_cast<int>(CubeState::getCornerFacelet(corner, (5 - twist) % 3));
+                this->corners[(first * 6 + second) * 6 + third] = static_cast<int8_t>(corner * 3 + twist);
+            }
+        }
+
+        for (int edge = 0; edge < CubeState::EDGES; edge++) {
+            int first = static_cast<int>(CubeState::getEdgeFacelet(edge, 0));
+            int second = static_cast<int>(CubeState::getEdgeFacelet(edge, 1));
+            this->edges[first * 6 + second] = static_cast<int8_t>(edge * 2);
+            this->edges[second * 6 + first] = static_cast<int8_t>(edge * 2 + 1);
+        }
+    }
+
+    // -1 for anything but a face name
+    int getFace(char name) const {
+        return this->faces[static_cast<unsigned char>(name)];
+    }
+
+    // Corner times three plus its twist
+    int getCorner(int first, int second, int third) const {
+        return this->corners[(first * 6 + second) * 6 + third];
+    }
+
+    // Edge times two plus its flip
+    int getEdge(int first, int second) const {
+        return this->edges[first * 6 + second];
+    }
+
+private:
+    int8_t faces[256];
+    int8_t corners[216];
+    int8_t edges[36];
+};
+
+const CubieTable& getCubieTable() {
+    static const CubieTable cubieTable;
+    return cubieTable;
+}
+
+// Parity of the inversion count, every value counts the smaller ones after it without branching
+template<size_t N>
+int parity(const int (&permutation)[N]) {
+    unsigned int after = 0;
+    int inversions = 0;
+    for (size_t slot = N; slot-- > 0; ) {
+        inversions += std::bitset<N>(after & ((1u << permutation[slot]) - 1)).count();
+        after |= 1u << permutation[slot];
+    }
+
+    return inversions & 1;
+}
+
+// Legality of a state given as cubies and orientations per slot, cubies already known to be in range
+NotationError check(const int (&corners)[CubeState::CORNERS], const int (&twists)[CubeState::CORNERS],
+        const int (&edges)[CubeState::EDGES], const int (&flips)[CubeState::EDGES]) {
+    unsigned int cornerSet = 0;
+    int twist = 0;
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        cornerSet |= 1u << corners[slot];
+        twist += twists[slot];
+    }
+
+    unsigned int edgeSet = 0;
+    int flip = 0;
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        edgeSet |= 1u << edges[slot];
+        flip += flips[slot];
+    }
+
+    if (cornerSet != (1u << CubeState::CORNERS) - 1 || edgeSet != (1u << CubeState::EDGES) - 1) {
+        return NotationError::CUBIE;
+    }
+
+    if (twist % 3 != 0) {
+        return NotationError::TWIST;
+    }
+
+    if (flip % 2 != 0) {
+        return NotationError::FLIP;
+    }
+
+    if (parity(corners) != parity(edges)) {
+        return NotationError::PARITY;
+    }
+
+    return NotationError::NONE;
+}
+
+}  // namespace
+
+Notation::Result Notation::parseMoves(std::string_view text, Move* moves, size_t capacity) {
+    Face frame[6] = { Face::U, Face::R, Face::F, Face::D, Face::L, Face::B };
+    Result result = { NotationError::NONE, 0, 0 };
+    bool isFull = false;
+
+    auto turn = [&frame, &result, &isFull, moves, capacity](Face face, int turns) {
+        turns &= 3;
+        if (turns == 0) {
+            return;
+        }
+
+        if (result.moves == capacity) {
+            isFull = true;
+            return;
+        }
+
+        moves[result.moves++] = static_cast<Move>(static_cast<int>(frame[static_cast<int>(face)]) * 3 + turns - 1);
+    };
+
+    auto rotate = [&frame](int axis, int turns) {
+        const Face* cycle = rotationCycles[axis];
+        for (int turn = 0; turn < (turns & 3); turn++) {
+            Face first = frame[static_cast<int>(cycle[0])];
+            for (int position = 0; position < 3; position++) {
+                frame[static_cast<int>(cycle[position])] = frame[static_cast<int>(cycle[position + 1])];
+            }
+            frame[static_cast<int>(cycle[3])] = first;
+        }
+    };
+
+    const CubieTable& table = getCubieTable();
+    const char* data = text.data();
+    size_t length = text.size();
+    size_t position = 0;
+
+    while (position < length) {
+        char name = data[position];
+        if (name == ' ' || name == '\t' || name == '\r' || name == '\n' || name == '(' || name == ')') {
+            position++;
+            continue;
+        }
+
+        // Suffixes are read without branching, turns are mispredicted often enough as it is
+        size_t start = position++;
+        bool isWide = (position < length && data[position] == 'w');
+        position += isWide;
+        bool isDouble = (position < length && data[position] == '2');
+        position += isDouble;
+        bool isPrime = (position < length && data[position] == '\'');
+        position += isPrime;
+        int turns = (1 + isDouble) * (1 - 2 * isPrime);
+
+        // Plain face turns, most of any corpus, go straight through the frame
+        int face = table.getFace(name);
+        if (face >= 0 && !isWide && result.moves < capacity) {
+            moves[result.moves++] = static_cast<Move>(static_cast<int>(frame[face]) * 3 + (turns & 3) - 1);
+            continue;
+        }
+
+        if (isWide) {
+            name = (face >= 0) ? static_cast<char>(name - 'A' + 'a') : '\0';  // Rw is r
+        }
+
+        size_t written = result.moves;
+        switch (name) {
+            case 'U': turn(Face::U, turns); break;
+            case 'R': turn(Face::R, turns); break;
+            case 'F': turn(Face::F, turns); break;
+            case 'D': turn(Face::D, turns); break;
+            case 'L': turn(Face::L, turns); break;
+            case 'B': turn(Face::B, turns); break;
+
+            // Wide turns are the opposite face and a whole cube turn
+            case 'u': turn(Face::D, turns); rotate(1, turns); break;
+            case 'r': turn(Face::L, turns); rotate(0, turns); break;
+            case 'f': turn(Face::B, turns); rotate(2, turns); break;
+            case 'd': turn(Face::U, turns); rotate(1, -turns); break;
+            case 'l': turn(Face::R, turns); rotate(0, -turns); break;
+            case 'b': turn(Face::F, turns); rotate(2, -turns); break;
+
+            // Slices are both faces around them and a whole cube turn
+            case 'M': turn(Face::R, turns); turn(Face::L, -turns); rotate(0, -turns); break;
+            case 'E': turn(Face::U, turns); turn(Face::D, -turns); rotate(1, -turns); break;
+            case 'S': turn(Face::F, -turns); turn(Face::B, turns); rotate(2, turns); break;
+
+            case 'x': rotate(0, turns); break;
+            case 'y': rotate(1, turns); break;
+            case 'z': rotate(2, turns); break;
+
+            default:
+                result.error = NotationError::MOVE;
+                result.offset = start;
+                return result;
+        }
+
+        if (isFull) {
+            result.error = NotationError::LENGTH;
+            result.moves = written;
+            result.offset = start;
+            return result;
+        }
+    }
+
+    result.offset = length;
+    return result;
+}
+
+size_t Notation::formatMoves(const Move* moves, size_t count, char* buffer, size_t capacity) {
+    size_t length = 0;
+    for (size_t index = 0; index < count; index++) {
+        int move = static_cast<int>(moves[index]);
+        int turns = move % 3 + 1;
+        size_t required = (index > 0 ? 1 : 0) + (turns == 1 ? 1 : 2);
+        if (length + required > capacity) {
+            return 0;
+        }
+
+        if (index > 0) {
+            buffer[length++] = ' ';
+        }
+
+        buffer[length++] = faceNames[move / 3];
+        if (turns != 1) {
+            buffer[length++] = (turns == 2) ? '2' : '\'';
+        }
+    }
+
+    return length;
+}
+
+NotationError Notation::parseFacelets(std::string_view text, CubeState& state) {
+    if (text.size() != FACELETS) {
+        return NotationError::LENGTH;
+    }
+
+    const CubieTable& table = getCubieTable();
+    int faces[FACELETS];
+    int invalid = 0;
+    for (int facelet = 0; facelet < FACELETS; facelet++) {
+        faces[facelet] = table.getFace(text[facelet]);
+        invalid |= faces[facelet];
+    }
+
+    if (invalid < 0) {
+        return NotationError::FACELET;
+    }
+
+    for (int face = 0; face < 6; face++) {
+        if (faces[face * 9 + 4] != face) {
+            return NotationError::CENTER;
+        }
+    }
+
+    int corners[CubeState::CORNERS], twists[CubeState::CORNERS];
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        const int* facelets = cornerFacelets[slot];
+        int corner = table.getCorner(faces[facelets[0]], faces[facelets[1]], faces[facelets[2]]);
+        invalid |= corner;
+
+        corners[slot] = corner / 3;
+        twists[slot] = corner % 3;
+    }
+
+    int edges[CubeState::EDGES], flips[CubeState::EDGES];
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        int edge = table.getEdge(faces[edgeFacelets[slot][0]], faces[edgeFacelets[slot][1]]);
+        invalid |= edge;
+
+        edges[slot] = edge / 2;
+        flips[slot] = edge % 2;
+    }
+
+    if (invalid < 0) {
+        return NotationError::CUBIE;
+    }
+
+    NotationError error = check(corners, twists, edges, flips);
+    if (error != NotationError::NONE) {
+        return error;
+    }
+
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        state.corners[slot] = static_cast<uint8_t>(corners[slot]);
+        state.cornerOrientations[slot] = static_cast<uint8_t>(twists[slot]);
+    }
+
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        state.edges[slot] = static_cast<uint8_t>(edges[slot]);
+        state.edgeOrientations[slot] = static_cast<uint8_t>(flips[slot]);
+    }
+
+    return NotationError::NONE;
+}
+
+void Notation::formatFacelets(const CubeState& state, char* buffer) {
+    for (int face = 0; face < 6; face++) {
+        buffer[face * 9 + 4] = faceNames[face];
+    }
+
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        int corner = state.getCorner(slot);
+        int twist = state.getCornerOrientation(slot);
+        for (int facelet = 0; facelet < 3; facelet++) {
+            Face face = CubeState::getCornerFacelet(corner, (facelet + 3 - twist) % 3);
+            buffer[cornerFacelets[slot][facelet]] = faceNames[static_cast<int>(face)];
+        }
+    }
+
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        int edge = state.getEdge(slot);
+        int flip = state.getEdgeOrientation(slot);
+        for (int facelet = 0; facelet < 2; facelet++) {
+            Face face = CubeState::getEdgeFacelet(edge, (facelet + flip) % 2);
+            buffer[edgeFacelets[slot][facelet]] = faceNames[static_cast<int>(face)];
+        }
+    }
+}
+
+NotationError Notation::validate(const CubeState& state) {
+    int corners[CubeState::CORNERS], twists[CubeState::CORNERS];
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        corners[slot] = state.getCorner(slot);
+        twists[slot] = state.getCornerOrientation(slot);
+    }
+
+    int edges[CubeState::EDGES], flips[CubeState::EDGES];
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        edges[slot] = state.getEdge(slot);
+        flips[slot] = state.getEdgeOrientation(slot);
+    }
+
+    return check(corners, twists, edges, flips);
+}
+
+std::string_view Notation::nextLine(std::string_view& text) {
+    const void* end = std::memchr(text.data(), '\n', text.size());
+    size_t length = (end != nullptr) ? static_cast<const char*>(end) - text.data() : text.size();
+
+    std::string_view line(text.data(), length);
+    text.remove_prefix(std::min(length + 1, text.size()));
+
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    return line;
+}
+
+const char* Notation::getErrorName(NotationError error) {
+    return errorNames[static_cast<int>(error)];
+}
+
+}  // namespace Rubik
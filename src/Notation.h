@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <CubeState.h>
+#include <string_view>
+#include <cstddef>
+
+namespace Rubik {
+
+enum class NotationError { NONE, MOVE, LENGTH, FACELET, CENTER, CUBIE, TWIST, FLIP, PARITY };
+
+// Text forms of moves and states for bulk input and output. Nothing allocates: text is read from
+// string views (an mmap'd corpus works as well as a string) and written to caller buffers.
+//
+// Moves are the usual notation, face turns (R U R' U2), wide turns (r, Rw), slices (M E S) and
+// whole cube turns (x y z), optionally separated by whitespace or parentheses. They are parsed to
+// face turns of the cube the sequence starts on, i.e. a slice becomes two face turns.
+//
+// Facelet strings name the face color of all 54 facelets, the faces in U, R, F, D, L, B order and
+// every face read row by row as seen from outside, U with B on top and D with F on top.
+class Notation {
+public:
+    static const int FACELETS = 54;
+    static const int MOVE_LENGTH = 3;  // Characters formatMoves() takes per move at most
+
+    struct Result {
+        NotationError error;
+        size_t moves;   // Moves written
+        size_t offset;  // Characters consumed, on error where the offending move starts
+    };
+
+    static Result parseMoves(std::string_view text, Move* moves, size_t capacity);
+    static size_t formatMoves(const Move* moves, size_t count, char* buffer, size_t capacity);
+
+    // The state is left alone if the facelets are not a reachable state
+    static NotationError parseFacelets(std::string_view text, CubeState& state);
+    static void formatFacelets(const CubeState& state, char* buffer);
+
+    // Cubies, twist, flip and parity of a state, NONE if it can be reached by turns
+    static NotationError validate(const CubeState& state);
+
+    // Splits the next line off the text, without its end of line
+    static std::string_view nextLine(std::string_view& text);
+
+    static const char* getErrorName(NotationError error);
+};
+
+}  // namespace Rubik
+
+#endif  // NOTATION_H
@@ -21,15 +21,21 @@
  */
 
 #include <Puzzle.h>
-#include <ObjectGroup.h>
-#include <Logger.h>
-#include <Vec3.h>
+#include <Symmetry.h>
 #include <algorithm>
 #include <stdexcept>
+#include <utility>
+#include <cmath>
 #include <cstdlib>
 
 namespace Rubik {
 
+Puzzle::Puzzle() {
+    std::fill_n(&this->cubes[0][0][0], CUBES, -1);
+    std::fill_n(this->cells, CUBES, -1);
+    std::fill_n(this->cubeIds, CUBES, -1);
+}
+
 int Puzzle::getSelectedCube() const {
     return this->selectedCube;
 }
@@ -54,77 +60,179 @@ void Puzzle::setRotationSpeed(float rotationSpeed) {
     this->rotationSpeed = rotationSpeed;
 }
 
-void Puzzle::addCube(const std::shared_ptr<Graphene::Entity>& cube) {
-    if (this->attachedCubes >= 27) {
-        throw std::runtime_error(Graphene::LogFormat("attachCube()"));
+void Puzzle::addCube(int objectId) {
+    if (this->attachedCubes >= CUBES) {
+        throw std::runtime_error("Puzzle: all cubes are already attached");
     }
 
-    std::shared_ptr<Graphene::Entity>* cubes = &this->cubes[0][0][0];
-    std::shared_ptr<Graphene::Entity>* solution = &this->solution[0][0][0];
+    int* cubes = &this->cubes[0][0][0];
+    cubes[this->attachedCubes] = this->attachedCubes;
+    this->cells[this->attachedCubes] = this->attachedCubes;
+    this->cubeIds[this->attachedCubes++] = objectId;
+}
 
-    cubes[this->attachedCubes] = cube;
-    solution[this->attachedCubes] = cube;
-    this->attachedCubes++;
+int Puzzle::getCubeId(int cube) const {
+    return this->cubeIds[cube];
+}
+
+const Quaternion& Puzzle::getCubeRotation(int cube) const {
+    return this->rotations[cube];
 }
 
 std::tuple<int, int, int> Puzzle::getCubePosition(int objectId) const {
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            for (int k = 0; k < 3; k++) {
-                if (this->cubes[i][j][k]->getId() == objectId) {
-                    return std::make_tuple(i, j, k);
-                }
-            }
-        }
+    int cube = this->findCube(objectId);
+    if (cube == -1) {
+        return std::make_tuple(-1, -1, -1);
+    }
+
+    int cell = this->cells[cube];
+    return std::make_tuple(cell / 9, cell / 3 % 3, cell % 3);
+}
+
+int Puzzle::getCubeCell(int cube) const {
+    return this->cells[cube];
+}
+
+bool Puzzle::getTurningLayer(int& axis, int& layer) const {
+    if (this->animationState == AnimationState::IDLE || this->animatedCube == -1) {
+        return false;  // Whole cube rotations keep the layers together
+    }
+
+    int cube = this->findCube(this->animatedCube);
+    if (cube == -1) {
+        return false;
     }
 
-    return std::make_tuple(-1, -1, -1);
+    int cell = this->cells[cube];
+    switch (this->animationState) {
+        case AnimationState::DOWN_ROTATION:
+        case AnimationState::UP_ROTATION:
+            axis = 0;
+            layer = cell / 9;
+            return true;
+
+        default:
+            axis = 1;
+            layer = cell / 3 % 3;
+            return true;
+    }
+}
+
+const CubeState& Puzzle::getState() const {
+    return this->cubeState;
+}
+
+int Puzzle::getFrame() const {
+    return this->frame;
 }
 
 void Puzzle::shuffle(int times) {
     for (int i = 0; i < times; i++) {
-        this->selectedCube = this->cubes[std::rand() % 3][std::rand() % 3][std::rand() % 3]->getId();
-        this->state = static_cast<AnimationState>(std::rand() % 4 + 1);
-        this->update(90.0f / this->rotationSpeed);
+        int objectId = this->cubeIds[this->cubes[std::rand() % 3][std::rand() % 3][std::rand() % 3]];
+        this->turn(objectId, static_cast<AnimationState>(std::rand() % 4 + 1));
+    }
+}
+
+void Puzzle::shuffle(const std::vector<Move>& moves) {
+    for (Move move: moves) {
+        for (int i = 0; i < MoveTurns(move); i++) {
+            this->turnFace(MoveFace(move));
+        }
     }
 }
 
-bool Puzzle::isSolved() {
-    bool solved = false;
+bool Puzzle::isSolved() const {
+    // Centers define the reference, so every whole cube rotation of a solved cube counts
+    return this->cubeState.isSolved();
+}
 
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            if (!solved && this->isOrdered()) {
-                solved = true;
-            }
+void Puzzle::save(Record& record) const {
+    const int* cubes = &this->cubes[0][0][0];
+    for (int cell = 0; cell < CUBES; cell++) {
+        record.cubes[cell] = static_cast<int8_t>(cubes[cell]);
+    }
 
-            for (int k = 0; k < 3; k++) {
-                this->rotateFacet(k, k, AnimationState::RIGHT_ROTATION);
-            }
+    bool isTurning = (this->animationState != AnimationState::IDLE);
+    record.animatedCube = static_cast<int8_t>(isTurning ? this->findCube(this->animatedCube) : -1);
+    record.animationState = static_cast<int8_t>(this->animationState);
+    record.frame = static_cast<int8_t>(this->frame);
+    Notation::formatFacelets(this->cubeState, record.facelets);
+    record.rotationAngle = this->rotationAngle;
+
+    for (int cube = 0; cube < CUBES; cube++) {
+        const Quaternion& rotation = this->rotations[cube];
+        record.rotations[cube][0] = rotation.getW();
+        record.rotations[cube][1] = rotation.getX();
+        record.rotations[cube][2] = rotation.getY();
+        record.rotations[cube][3] = rotation.getZ();
+    }
+}
+
+bool Puzzle::restore(const Record& record) {
+    if (this->attachedCubes != CUBES) {
+        return false;
+    }
+
+    bool placed[CUBES] = { };
+    for (int cell = 0; cell < CUBES; cell++) {
+        int cube = record.cubes[cell];
+        if (cube < 0 || cube >= CUBES || placed[cube]) {
+            return false;
         }
+        placed[cube] = true;
+    }
 
-        for (int k = 0; k < 3; k++) {
-            this->rotateFacet(k, k, AnimationState::UP_ROTATION);
+    AnimationState animationState = static_cast<AnimationState>(record.animationState);
+    if (record.animationState < static_cast<int8_t>(AnimationState::IDLE) ||
+            record.animationState > static_cast<int8_t>(AnimationState::DOWN_ROTATION) ||
+            record.animatedCube < -1 || record.animatedCube >= CUBES ||
+            record.frame < 0 || record.frame >= Symmetry::ROTATIONS ||
+            !(record.rotationAngle >= 0.0f && record.rotationAngle < 90.0f)) {
+        return false;
+    }
+
+    CubeState cubeState;
+    if (Notation::parseFacelets(std::string_view(record.facelets, Notation::FACELETS), cubeState) != NotationError::NONE) {
+        return false;
+    }
+
+    Quaternion rotations[CUBES];
+    for (int cube = 0; cube < CUBES; cube++) {
+        const float* rotation = record.rotations[cube];
+        float norm = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] +
+                rotation[2] * rotation[2] + rotation[3] * rotation[3]);
+        if (!(std::fabs(norm - 1.0f) < 0.001f)) {
+            return false;  // NaN included
         }
+        rotations[cube] = Quaternion(rotation[0], rotation[1], rotation[2], rotation[3]).normalize();
     }
 
-    return solved;
+    std::copy_n(record.cubes, CUBES, &this->cubes[0][0][0]);
+    std::copy_n(rotations, CUBES, this->rotations);
+    this->updateCells();
+    this->cubeState = cubeState;
+    this->frame = record.frame;
+
+    // The turn picks up where it stopped, requests that hadn't started yet are gone
+    bool isTurning = (animationState != AnimationState::IDLE);
+    this->animationState = animationState;
+    this->state = animationState;
+    this->animatedCube = (isTurning && record.animatedCube != -1) ? this->cubeIds[record.animatedCube] : -1;
+    this->selectedCube = this->animatedCube;
+    this->rotationAngle = isTurning ? record.rotationAngle : 0.0f;
+    return true;
 }
 
 void Puzzle::update(float frameTime) {
-    static int selectedCube = this->selectedCube;
-    static AnimationState state = this->state;
-
-    if (state == AnimationState::IDLE && this->state != AnimationState::IDLE) {
-        selectedCube = this->selectedCube;
-        state = this->state;
+    if (this->animationState == AnimationState::IDLE && this->state != AnimationState::IDLE) {
+        this->animatedCube = this->selectedCube;
+        this->animationState = this->state;
     }
 
-    static float rotationAngle = 0.0f;
     float rotationDirection = 1.0f;
     float stepAngle = this->rotationSpeed * frameTime;
 
-    switch (state) {
+    switch (this->animationState) {
         case AnimationState::RIGHT_ROTATION:
         case AnimationState::DOWN_ROTATION:
             rotationDirection = -1.0f;
@@ -132,32 +240,32 @@ void Puzzle::update(float frameTime) {
 
         case AnimationState::LEFT_ROTATION:
         case AnimationState::UP_ROTATION:
-            if (rotationAngle + stepAngle > 90.0f) {
-                stepAngle = 90.0f - rotationAngle;
+            if (this->rotationAngle + stepAngle > 90.0f) {
+                stepAngle = 90.0f - this->rotationAngle;
             }
 
-            rotationAngle += stepAngle;
+            this->rotationAngle += stepAngle;
             stepAngle *= rotationDirection;
 
-            if (selectedCube != -1) {
-                std::tuple<int, int, int> cubePosition(this->getCubePosition(selectedCube));
-                this->rotateEntities(std::get<0>(cubePosition), std::get<1>(cubePosition), stepAngle, state);
-                if (rotationAngle == 90.0f) {
-                    this->rotateFacet(std::get<0>(cubePosition), std::get<1>(cubePosition), state);
+            if (this->animatedCube != -1) {
+                int cell = this->cells[this->findCube(this->animatedCube)];
+                this->rotateEntities(cell / 9, cell / 3 % 3, stepAngle, this->animationState);
+                if (this->rotationAngle == 90.0f) {
+                    this->rotateFacet(cell / 9, cell / 3 % 3, this->animationState);
                 }
             } else {
                 for (int i = 0; i < 3; i++) {
-                    this->rotateEntities(i, i, stepAngle, state);
-                    if (rotationAngle == 90.0f) {
-                        this->rotateFacet(i, i, state);
+                    this->rotateEntities(i, i, stepAngle, this->animationState);
+                    if (this->rotationAngle == 90.0f) {
+                        this->rotateFacet(i, i, this->animationState);
                     }
                 }
             }
 
-            if (rotationAngle == 90.0f) {
+            if (this->rotationAngle == 90.0f) {
                 this->state = AnimationState::IDLE;
-                state = AnimationState::IDLE;
-                rotationAngle = 0.0f;
+                this->animationState = AnimationState::IDLE;
+                this->rotationAngle = 0.0f;
             }
             break;
 
@@ -166,71 +274,184 @@ void Puzzle::update(float frameTime) {
     }
 }
 
+int Puzzle::findCube(int objectId) const {
+    int cube = static_cast<int>(std::find(this->cubeIds, this->cubeIds + this->attachedCubes, objectId) - this->cubeIds);
+    return (cube < this->attachedCubes) ? cube : -1;
+}
+
+void Puzzle::updateCells() {
+    const int* cubes = &this->cubes[0][0][0];
+    for (int cell = 0; cell < CUBES; cell++) {
+        if (cubes[cell] != -1) {
+            this->cells[cubes[cell]] = cell;
+        }
+    }
+}
+
+void Puzzle::turn(int objectId, AnimationState state) {
+    this->selectedCube = objectId;
+    this->state = state;
+    this->update(90.0f / this->rotationSpeed);
+}
+
+void Puzzle::turnFace(Face face) {
+    // U is the top layer, F faces the camera and R is on its right (cubes[0][][])
+    switch (face) {
+        case Face::U:
+            this->turn(this->cubeIds[this->cubes[0][2][0]], AnimationState::RIGHT_ROTATION);
+            break;
+
+        case Face::D:
+            this->turn(this->cubeIds[this->cubes[0][0][0]], AnimationState::LEFT_ROTATION);
+            break;
+
+        case Face::R:
+            this->turn(this->cubeIds[this->cubes[0][0][0]], AnimationState::UP_ROTATION);
+            break;
+
+        case Face::L:
+            this->turn(this->cubeIds[this->cubes[2][0][0]], AnimationState::DOWN_ROTATION);
+            break;
+
+        case Face::F:
+        case Face::B:
+            // No rotation around the view axis, bring the facet sideways and back
+            this->turn(-1, AnimationState::LEFT_ROTATION);
+            if (face == Face::F) {
+                this->turn(this->cubeIds[this->cubes[0][0][0]], AnimationState::UP_ROTATION);
+            } else {
+                this->turn(this->cubeIds[this->cubes[2][0][0]], AnimationState::DOWN_ROTATION);
+            }
+
+            this->turn(-1, AnimationState::RIGHT_ROTATION);
+            break;
+    }
+}
+
 void Puzzle::rotateFacet(int row, int column, AnimationState state) {
+    this->rotateState(row, column, state);
+
     for (int i = 0; i < 2; i++) {
         switch (state) {
             case AnimationState::LEFT_ROTATION:
-                this->cubes[i][column][0].swap(this->cubes[2][column][i]);
-                this->cubes[2][column][i].swap(this->cubes[2 - i][column][2]);
-                this->cubes[2 - i][column][2].swap(this->cubes[0][column][2 - i]);
+                std::swap(this->cubes[i][column][0], this->cubes[2][column][i]);
+                std::swap(this->cubes[2][column][i], this->cubes[2 - i][column][2]);
+                std::swap(this->cubes[2 - i][column][2], this->cubes[0][column][2 - i]);
                 break;
 
             case AnimationState::RIGHT_ROTATION:
-                this->cubes[2 - i][column][2].swap(this->cubes[0][column][2 - i]);
-                this->cubes[2][column][i].swap(this->cubes[2 - i][column][2]);
-                this->cubes[i][column][0].swap(this->cubes[2][column][i]);
+                std::swap(this->cubes[2 - i][column][2], this->cubes[0][column][2 - i]);
+                std::swap(this->cubes[2][column][i], this->cubes[2 - i][column][2]);
+                std::swap(this->cubes[i][column][0], this->cubes[2][column][i]);
                 break;
 
             case AnimationState::DOWN_ROTATION:
-                this->cubes[row][i][0].swap(this->cubes[row][2][i]);
-                this->cubes[row][2][i].swap(this->cubes[row][2 - i][2]);
-                this->cubes[row][2 - i][2].swap(this->cubes[row][0][2 - i]);
+                std::swap(this->cubes[row][i][0], this->cubes[row][2][i]);
+                std::swap(this->cubes[row][2][i], this->cubes[row][2 - i][2]);
+                std::swap(this->cubes[row][2 - i][2], this->cubes[row][0][2 - i]);
                 break;
 
             case AnimationState::UP_ROTATION:
-                this->cubes[row][2 - i][2].swap(this->cubes[row][0][2 - i]);
-                this->cubes[row][2][i].swap(this->cubes[row][(2 - i)][2]);
-                this->cubes[row][i][0].swap(this->cubes[row][2][i]);
+                std::swap(this->cubes[row][2 - i][2], this->cubes[row][0][2 - i]);
+                std::swap(this->cubes[row][2][i], this->cubes[row][(2 - i)][2]);
+                std::swap(this->cubes[row][i][0], this->cubes[row][2][i]);
                 break;
 
             default:
                 break;
         }
     }
+
+    this->updateCells();
+}
+
+void Puzzle::rotateState(int row, int column, AnimationState state) {
+    // Faces of the first and the last layer, a positive turn is clockwise looking at the first one
+    Face firstFace, lastFace;
+    int layer;
+    bool positive;
+    int rotation;
+
+    // Positive quarter turns of the whole cube around X (UP_ROTATION) and Y (LEFT_ROTATION)
+    static const int xRotation = Symmetry::find(Face::B, Face::R, Face::U);
+    static const int yRotation = Symmetry::find(Face::U, Face::B, Face::R);
+
+    switch (state) {
+        case AnimationState::LEFT_ROTATION:
+        case AnimationState::RIGHT_ROTATION:
+            firstFace = Face::D;
+            lastFace = Face::U;
+            layer = column;
+            positive = (state == AnimationState::LEFT_ROTATION);
+            rotation = yRotation;
+            break;
+
+        case AnimationState::UP_ROTATION:
+        case AnimationState::DOWN_ROTATION:
+            firstFace = Face::R;
+            lastFace = Face::L;
+            layer = row;
+            positive = (state == AnimationState::UP_ROTATION);
+            rotation = xRotation;
+            break;
+
+        default:
+            return;
+    }
+
+    auto turnFace = [this](Face spatialFace, bool clockwise) {
+        int face = static_cast<int>(Symmetry::getFace(Symmetry::inverse(this->frame), spatialFace));
+        this->cubeState.applyMove(static_cast<Move>(face * 3 + (clockwise ? 0 : 2)));
+    };
+
+    switch (layer) {
+        case 0:
+            turnFace(firstFace, positive);
+            break;
+
+        case 2:
+            turnFace(lastFace, !positive);
+            break;
+
+        default:
+            // Middle layer is the whole cube turned one way and the outer layers the other way
+            turnFace(firstFace, !positive);
+            turnFace(lastFace, positive);
+
+            this->frame = Symmetry::multiply(positive ? rotation : Symmetry::inverse(rotation), this->frame);
+            break;
+    }
 }
 
 void Puzzle::rotateEntities(int row, int column, float angle, AnimationState state) {
     switch (state) {
         case AnimationState::DOWN_ROTATION:
-        case AnimationState::UP_ROTATION:
+        case AnimationState::UP_ROTATION: {
+            Quaternion rotation(Quaternion::fromAxisAngle(1.0f, 0.0f, 0.0f, angle));
             for (int j = 0; j < 3; j++) {
                 for (int k = 0; k < 3; k++) {
-                    // Rotate the parent Graphene::ObjectGroup
-                    this->cubes[row][j][k]->getParent()->rotate(Math::Vec3::UNIT_X, angle);
+                    Quaternion& cubeRotation = this->rotations[this->cubes[row][j][k]];
+                    cubeRotation = (rotation * cubeRotation).normalize();
                 }
             }
             break;
+        }
 
         case AnimationState::LEFT_ROTATION:
-        case AnimationState::RIGHT_ROTATION:
+        case AnimationState::RIGHT_ROTATION: {
+            Quaternion rotation(Quaternion::fromAxisAngle(0.0f, 1.0f, 0.0f, angle));
             for (int i = 0; i < 3; i++) {
                 for (int k = 0; k < 3; k++) {
-                    // Rotate the parent Graphene::ObjectGroup
-                    this->cubes[i][column][k]->getParent()->rotate(Math::Vec3::UNIT_Y, angle);
+                    Quaternion& cubeRotation = this->rotations[this->cubes[i][column][k]];
+                    cubeRotation = (rotation * cubeRotation).normalize();
                 }
             }
             break;
+        }
 
         default:
             break;
     }
 }
 
-bool Puzzle::isOrdered() const {
-    const std::shared_ptr<Graphene::Entity>* cubes = &this->cubes[0][0][0];
-    const std::shared_ptr<Graphene::Entity>* solution = &this->solution[0][0][0];
-
-    return std::equal(cubes, cubes + this->attachedCubes, solution);
-}
-
 }  // namespace Rubik
@@ -23,16 +23,39 @@
 #ifndef PUZZLE_H
 #define PUZZLE_H
 
-#include <NonCopyable.h>
-#include <Entity.h>
+#include <CubeState.h>
+#include <Notation.h>
+#include <Quaternion.h>
 #include <tuple>
+#include <vector>
+#include <cstdint>
 
 namespace Rubik {
 
 enum class AnimationState { IDLE, LEFT_ROTATION, RIGHT_ROTATION, UP_ROTATION, DOWN_ROTATION };
 
-class Puzzle: public Graphene::NonCopyable {
+// Cubes are known by object id and their orientations are kept as quaternions for the caller to
+// apply to the scene, the puzzle itself never touches Graphene objects.
+class Puzzle {
 public:
+    static const int CUBES = 27;
+
+    // Everything a turn leaves behind, a turn in progress included, in a plain layout to be written
+    // out. Cubes are kept in addCube() order, object ids don't outlive the process.
+    struct Record {
+        int8_t cubes[CUBES];    // Cube at each grid position
+        int8_t animatedCube;    // Cube of the turn in progress, -1 for a whole cube turn
+        int8_t animationState;  // AnimationState of the turn in progress
+        int8_t frame;
+        char facelets[Notation::FACELETS];  // Logical state relative to the centers
+        float rotationAngle;
+        float rotations[CUBES][4];  // w, x, y, z
+    };
+
+    Puzzle();
+    Puzzle(const Puzzle&) = delete;
+    Puzzle& operator=(const Puzzle&) = delete;
+
     int getSelectedCube() const;
     void selectCube(int objectId);
 
@@ -42,26 +65,60 @@ public:
     float getRotationSpeed() const;
     void setRotationSpeed(float rotationSpeed);
 
-    void addCube(const std::shared_ptr<Graphene::Entity>& cube);
+    void addCube(int objectId);
+    int getCubeId(int cube) const;
+    const Quaternion& getCubeRotation(int cube) const;
     std::tuple<int, int, int> getCubePosition(int objectId) const;
+    int getCubeCell(int cube) const;  // Grid position i * 9 + j * 3 + k of a cube
+
+    // Grid axis (0 for i, 1 for j) and index of the layer being turned, false if none is
+    bool getTurningLayer(int& axis, int& layer) const;
+
+    const CubeState& getState() const;
+    int getFrame() const;  // Rotation taking the centers to where they are, see Symmetry
 
     void shuffle(int times);
-    bool isSolved();
+    void shuffle(const std::vector<Move>& moves);
+    bool isSolved() const;
+
+    // Restoring needs all cubes attached, a broken record is refused and leaves the puzzle alone
+    void save(Record& record) const;
+    bool restore(const Record& record);
 
     void update(float frameTime);
 
 private:
+    friend class PuzzleBenchmark;
+
+    int findCube(int objectId) const;
+    void updateCells();
+
+    void turn(int objectId, AnimationState state);
+    void turnFace(Face face);
     void rotateFacet(int row, int column, AnimationState state);
+    void rotateState(int row, int column, AnimationState state);
     void rotateEntities(int row, int column, float angle, AnimationState state);
-    bool isOrdered() const;
 
-    std::shared_ptr<Graphene::Entity> cubes[3][3][3];
-    std::shared_ptr<Graphene::Entity> solution[3][3][3];
+    // Cube (in addCube() order) at each grid position and the other way around
+    int cubes[3][3][3];
+    int cells[CUBES];
+    int cubeIds[CUBES];
+    Quaternion rotations[CUBES];
+
+    // Logical state relative to the centers and the rotation taking the centers to where they are
+    CubeState cubeState;
+    int frame = 0;
+
     int attachedCubes = 0;
     int selectedCube = -1;
 
     AnimationState state = AnimationState::IDLE;
     float rotationSpeed = 300.0f;
+
+    // Turn in progress, requests made while it runs are picked up after it completes
+    int animatedCube = -1;
+    AnimationState animationState = AnimationState::IDLE;
+    float rotationAngle = 0.0f;
 };
 
 }  // namespace Rubik
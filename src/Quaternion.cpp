@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Quaternion.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Rubik {
+
+static const float PI = 3.14159265358979f;
+
+Quaternion::Quaternion():
+        Quaternion(1.0f, 0.0f, 0.0f, 0.0f) {
+}
+
+Quaternion::Quaternion(float w, float x, float y, float z):
+        w(w),
+        x(x),
+        y(y),
+        z(z) {
+}
+
+Quaternion Quaternion::fromAxisAngle(float x, float y, float z, float angle) {
+    float halfAngle = angle * PI / 360.0f;
+    float sine = std::sin(halfAngle);
+    return Quaternion(std::cos(halfAngle), x * sine, y * sine, z * sine);
+}
+
+float Quaternion::getW() const {
+    return this->w;
+}
+
+float Quaternion::getX() const {
+    return this->x;
+}
+
+float Quaternion::getY() const {
+    return this->y;
+}
+
+float Quaternion::getZ() const {
+    return this->z;
+}
+
+float Quaternion::getAngle() const {
+    // q and -q are the same rotation, take the short way round
+    return 2.0f * std::acos(std::min(std::fabs(this->w), 1.0f)) * 180.0f / PI;
+}
+
+void Quaternion::getAxis(float& x, float& y, float& z) const {
+    float length = std::sqrt(this->x * this->x + this->y * this->y + this->z * this->z);
+    if (length < 1e-6f) {
+        x = 1.0f;
+        y = 0.0f;
+        z = 0.0f;
+        return;
+    }
+
+    float sign = (this->w < 0.0f) ? -1.0f : 1.0f;
+    x = sign * this->x / length;
+    y = sign * this->y / length;
+    z = sign * this->z / length;
+}
+
+Quaternion Quaternion::conjugate() const {
+    return Quaternion(this->w, -this->x, -this->y, -this->z);
+}
+
+Quaternion Quaternion::normalize() const {
+    float length = std::sqrt(this->w * this->w + this->x * this->x + this->y * this->y + this->z * this->z);
+    return Quaternion(this->w / length, this->x / length, this->y / length, this->z / length);
+}
+
+Quaternion Quaternion::operator*(const Quaternion& other) const {
+    return Quaternion(
+        this->w * other.w - this->x * other.x - this->y * other.y - this->z * other.z,
+        this->w * other.x + this->x * other.w + this->y * other.z - this->z * other.y,
+        this->w * other.y - this->x * other.z + this->y * other.w + this->z * other.x,
+        this->w * other.z + this->x * other.y - this->y * other.x + this->z * other.w
+    );
+}
+
+}  // namespace Rubik
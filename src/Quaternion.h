@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+namespace Rubik {
+
+// Unit quaternion for cubie orientations, kept apart from Graphene objects so that the
+// simulation can run off the render thread. Angles are in degrees like Graphene::Object::rotate.
+class Quaternion {
+public:
+    Quaternion();
+    Quaternion(float w, float x, float y, float z);
+
+    static Quaternion fromAxisAngle(float x, float y, float z, float angle);
+
+    float getW() const;
+    float getX() const;
+    float getY() const;
+    float getZ() const;
+
+    // Rotation axis (unit length) and angle in [0, 180]; the axis is X for the identity
+    float getAngle() const;
+    void getAxis(float& x, float& y, float& z) const;
+
+    Quaternion conjugate() const;
+    Quaternion normalize() const;
+
+    Quaternion operator*(const Quaternion& other) const;
+
+private:
+    float w;
+    float x;
+    float y;
+    float z;
+};
+
+}  // namespace Rubik
+
+#endif  // QUATERNION_H
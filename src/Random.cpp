@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Random.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Rubik {
+
+Random::Random(uint64_t seed, uint64_t stream):
+        seed(seed),
+        stream(stream) {
+}
+
+uint64_t Random::getSeed() const {
+    return this->seed;
+}
+
+uint64_t Random::getStream() const {
+    return this->stream;
+}
+
+uint32_t Random::next() {
+    if (this->blockIndex == 4) {
+        this->generateBlock();
+    }
+
+    return this->block[this->blockIndex++];
+}
+
+uint32_t Random::uniform(uint32_t bound) {
+    if (bound == 0) {
+        throw std::invalid_argument("uniform(): zero bound");
+    }
+
+    // Reject the biased tail so every value is equally likely
+    uint32_t threshold = -bound % bound;
+    uint32_t value;
+
+    do {
+        value = this->next();
+    } while (value < threshold);
+
+    return value % bound;
+}
+
+void Random::generateBlock() {
+    uint32_t counter[4] = {
+        static_cast<uint32_t>(this->counter), static_cast<uint32_t>(this->counter >> 32),
+        static_cast<uint32_t>(this->stream), static_cast<uint32_t>(this->stream >> 32)
+    };
+    uint32_t key[2] = { static_cast<uint32_t>(this->seed), static_cast<uint32_t>(this->seed >> 32) };
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * counter[0];
+        uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * counter[2];
+
+        uint32_t next[4] = {
+            static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product1),
+            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product0)
+        };
+
+        std::copy(next, next + 4, counter);
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+
+    std::copy(counter, counter + 4, this->block.begin());
+    this->blockIndex = 0;
+    this->counter++;
+}
+
+}  // namespace Rubik
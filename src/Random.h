@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <cstdint>
+
+namespace Rubik {
+
+// Counter based Philox4x32-10 generator. Every (seed, stream) pair is an independent sequence
+// which is cheap to jump into, so the same scramble comes out on any platform and thread count.
+class Random {
+public:
+    Random(uint64_t seed, uint64_t stream);
+
+    uint64_t getSeed() const;
+    uint64_t getStream() const;
+
+    uint32_t next();
+    uint32_t uniform(uint32_t bound);
+
+private:
+    void generateBlock();
+
+    uint64_t seed;
+    uint64_t stream;
+    uint64_t counter = 0;
+
+    std::array<uint32_t, 4> block;
+    int blockIndex = 4;
+};
+
+}  // namespace Rubik
+
+#endif  // RANDOM_H
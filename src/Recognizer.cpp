@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Recognizer.h>
+#include <Symmetry.h>
+#include <StateRank.h>
+#include <Notation.h>
+#include <vector>
+#include <queue>
+#include <stdexcept>
+#include <cstdint>
+
+namespace Rubik {
+
+namespace {
+
+const int LAST_LAYER = 4;       // URF, UFL, ULB, UBR and UR, UF, UL, UB
+const int F2L_SLOTS = 4;        // FR, FL, BL, BR with the DFR, DLF, DBL, DRB corners
+const int OLL_STATES = 1296;    // 3^4 twists * 2^4 flips
+const int PLL_STATES = 576;     // 4! * 4!
+const int PAIR_STATES = 150;    // Corner in a U slot or its own * 3 twists, edge likewise * 2 flips
+
+const int FR_CORNER = 4;
+const int FR_EDGE = 8;
+const int PAIR_SLOT = 4;        // Pair position index of the F2L slot itself
+
+// Fixed cases, the rest follow in table order
+const int CROSS_CASE = 0;
+const int SOLVED_CASE = 1;
+
+struct Algorithm {
+    const char* name;
+    const char* algorithm;
+};
+
+const Algorithm ollAlgorithms[] = {
+    { "OLL 1", "R U2 R2 F R F' U2 R' F R F'" },
+    { "OLL 2", "F R U R' U' F' f R U R' U' f'" },
+    { "OLL 3", "f R U R' U' f' U' F R U R' U' F'" },
+    { "OLL 4", "f R U R' U' f' U F R U R' U' F'" },
+    { "OLL 5", "r' U2 R U R' U r" },
+    { "OLL 6", "r U2 R' U' R U' r'" },
+    { "OLL 7", "r U R' U R U2 r'" },
+    { "OLL 8", "r' U' R U' R' U2 r" },
+    { "OLL 9", "R U R' U' R' F R2 U R' U' F'" },
+    { "OLL 10", "R U R' U R' F R F' R U2 R'" },
+    { "OLL 11", "r U R' U R' F R F' R U2 r'" },
+    { "OLL 12", "M' R' U' R U' R' U2 R U' M" },
+    { "OLL 13", "F U R U' R2 F' R U R U' R'" },
+    { "OLL 14", "R' F R U R' F' R F U' F'" },
+    { "OLL 15", "r' U' r R' U' R U r' U r" },
+    { "OLL 16", "r U r' R U R' U' r U' r'" },
+    { "OLL 17", "R U R' U R' F R F' U2 R' F R F'" },
+    { "OLL 18", "r U R' U R U2 r2 U' R U' R' U2 r" },
+    { "OLL 19", "r' R U R U R' U' M' R' F R F'" },
+    { "OLL 20", "r U R' U' M2 U R U' R' U' M'" },
+    { "OLL 21", "R U2 R' U' R U R' U' R U' R'" },
+    { "OLL 22", "R U2 R2 U' R2 U' R2 U2 R" },
+    { "OLL 23", "R2 D' R U2 R' D R U2 R" },
+    { "OLL 24", "r U R' U' r' F R F'" },
+    { "OLL 25", "F' r U R' U' r' F R" },
+    { "OLL 26", "R U2 R' U' R U' R'" },
+    { "OLL 27", "R U R' U R U2 R'" },
+    { "OLL 28", "r U R' U' M U R U' R'" },
+    { "OLL 29", "R U R' U' R U' R' F' U' F R U R'" },
+    { "OLL 30", "F R' F R2 U' R' U' R U R' F2" },
+    { "OLL 31", "R' U' F U R U' R' F' R" },
+    { "OLL 32", "L U F' U' L' U L F L'" },
+    { "OLL 33", "R U R' U' R' F R F'" },
+    { "OLL 34", "R U R2 U' R' F R U R U' F'" },
+    { "OLL 35", "R U2 R2 F R F' R U2 R'" },
+    { "OLL 36", "L' U' L U' L' U L U L F' L' F" },
+    { "OLL 37", "F R' F' R U R U' R'" },
+    { "OLL 38", "R U R' U R U' R' U' R' F R F'" },
+    { "OLL 39", "L F' L' U' L U F U' L'" },
+    { "OLL 40", "R' F R U R' U' F' U R" },
+    { "OLL 41", "R U R' U R U2 R' F R U R' U' F'" },
+    { "OLL 42", "R' U' R U' R' U2 R F R U R' U' F'" },
+    { "OLL 43", "F' U' L' U L F" },
+    { "OLL 44", "F U R U' R' F'" },
+    { "OLL 45", "F R U R' U' F'" },
+    { "OLL 46", "R' U' R' F R F' U R" },
+    { "OLL 47", "R' U' R' F R F' R' F R F' U R" },
+    { "OLL 48", "F R U R' U' R U R' U' F'" },
+    { "OLL 49", "r U' r2 U r2 U r2 U' r" },
+    { "OLL 50", "r' U r2 U' r2 U' r2 U r'" },
+    { "OLL 51", "F U R U' R' U R U' R' F'" },
+    { "OLL 52", "R U R' U R U' B U' B' R'" },
+    { "OLL 53", "r' U' R U' R' U R U' R' U2 r" },
+    { "OLL 54", "r U R' U R U' R' U R U2 r'" },
+    { "OLL 55", "R' F R U R U' R2 F' R2 U' R' U R U R'" },
+    { "OLL 56", "r' U' r U' R' U R U' R' U R r' U r" },
+    { "OLL 57", "R U R' U' M' U R U' r'" }
+};
+
+const Algorithm pllAlgorithms[] = {
+    { "PLL Aa", "x R' U R' D2 R U' R' D2 R2 x'" },
+    { "PLL Ab", "x R2 D2 R U R' D2 R U' R x'" },
+    { "PLL E", "x' R U' R' D R U R' D' R U R' D R U' R' D' x" },
+    { "PLL F", "R' U' F' R U R' U' R' F R2 U' R' U' R U R' U R" },
+    { "PLL Ga", "R2 U R' U R' U' R U' R2 U' D R' U R D'" },
+    { "PLL Gb", "R' U' R U D' R2 U R' U R U' R U' R2 D" },
+    { "PLL Gc", "R2 U' R U' R U R' U R2 U D' R U' R' D" },
+    { "PLL Gd", "R U R' U' D R2 U' R U' R' U R' U R2 D'" },
+    { "PLL H", "M2 U M2 U2 M2 U M2" },
+    { "PLL Ja", "R' U L' U2 R U' R' U2 R L U'" },
+    { "PLL Jb", "R U R' F' R U R' U' R' F R2 U' R' U'" },
+    { "PLL Na", "R U R' U R U R' F' R U R' U' R' F R2 U' R' U2 R U' R'" },
+    { "PLL Nb", "R' U R U' R' F' U' F R U R' F R' F' R U' R" },
+    { "PLL Ra", "R U' R' U' R U R D R' U' R D' R' U2 R' U'" },
+    { "PLL Rb", "R2 F R U R U' R' F' R U2 R' U2 R" },
+    { "PLL T", "R U R' U' R' F R2 U' R' U' R U R' F'" },
+    { "PLL Ua", "R U' R U R U R U' R' U' R2" },
+    { "PLL Ub", "R2 U R U R' U' R' U' R' U R'" },
+    { "PLL V", "R' U R' U' y R' F' R2 U' R' U R' F R F" },
+    { "PLL Y", "F R U' R' U' R U R' F' R U R' U' R' F R F'" },
+    { "PLL Z", "M' U M2 U M2 U M' U2 M2" }
+};
+
+const size_t MAX_ALGORITHM_MOVES = 64;
+
+// Algorithm in the usual notation, wide, slice and whole cube turns included, as face turns of
+// the cube the algorithm starts on
+std::vector<Move> ExpandAlgorithm(const std::string& algorithm) {
+    Move moves[MAX_ALGORITHM_MOVES];
+    Notation::Result result = Notation::parseMoves(algorithm, moves, MAX_ALGORITHM_MOVES);
+    if (result.error != NotationError::NONE) {
+        throw std::logic_error("Recognizer: invalid algorithm " + algorithm);
+    }
+
+    return std::vector<Move>(moves, moves + result.moves);
+}
+
+std::vector<Move> InverseMoves(const std::vector<Move>& moves) {
+    std::vector<Move> inverse;
+    for (auto move = moves.rbegin(); move != moves.rend(); move++) {
+        inverse.push_back(InverseMove(*move));
+    }
+
+    return inverse;
+}
+
+std::string FormatMoves(const std::vector<Move>& moves) {
+    std::string text;
+    for (Move move: moves) {
+        text += (text.empty() ? "" : " ") + std::string(MoveName(move));
+    }
+
+    return text;
+}
+
+// U turns lining a last layer case up, "U' " for 3
+std::string FormatAdjustment(int turns, bool before) {
+    if (turns == 0) {
+        return "";
+    }
+
+    std::string name(MoveName(static_cast<Move>(static_cast<int>(Move::U) + turns - 1)));
+    return before ? name + " " : " " + name;
+}
+
+bool isCrossSolved(const CubeState& state) {
+    for (int slot = 4; slot < 8; slot++) {
+        if (state.getEdge(slot) != slot || state.getEdgeOrientation(slot) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool isPairSolved(const CubeState& state, int pair) {
+    int corner = FR_CORNER + pair;
+    int edge = FR_EDGE + pair;
+    return state.getCorner(corner) == corner && state.getCornerOrientation(corner) == 0 &&
+            state.getEdge(edge) == edge && state.getEdgeOrientation(edge) == 0;
+}
+
+bool isF2LSolved(const CubeState& state) {
+    bool solved = isCrossSolved(state);
+    for (int pair = 0; pair < F2L_SLOTS; pair++) {
+        solved = solved && isPairSolved(state, pair);
+    }
+
+    return solved;
+}
+
+// Position of the FR pair, -1 if either piece is in another slot
+int getPairIndex(const CubeState& state) {
+    int corner = -1;
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        if (state.getCorner(slot) == FR_CORNER) {
+            corner = (slot < LAST_LAYER) ? slot : (slot == FR_CORNER) ? PAIR_SLOT : -1;
+            corner = (corner == -1) ? -1 : corner * 3 + state.getCornerOrientation(slot);
+        }
+    }
+
+    int edge = -1;
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        if (state.getEdge(slot) == FR_EDGE) {
+            edge = (slot < LAST_LAYER) ? slot : (slot == FR_EDGE) ? PAIR_SLOT : -1;
+            edge = (edge == -1) ? -1 : edge * 2 + state.getEdgeOrientation(slot);
+        }
+    }
+
+    return (corner == -1 || edge == -1) ? -1 : corner * 10 + edge;
+}
+
+int getOllIndex(const CubeState& state) {
+    int index = 0;
+    for (int slot = 0; slot < LAST_LAYER; slot++) {
+        index = index * 3 + state.getCornerOrientation(slot);
+    }
+
+    for (int slot = 0; slot < LAST_LAYER; slot++) {
+        index = index * 2 + state.getEdgeOrientation(slot);
+    }
+
+    return index;
+}
+
+int getPllIndex(const CubeState& state) {
+    int corners[LAST_LAYER];
+    int edges[LAST_LAYER];
+    for (int slot = 0; slot < LAST_LAYER; slot++) {
+        corners[slot] = state.getCorner(slot);
+        edges[slot] = state.getEdge(slot);
+    }
+
+    return static_cast<int>(StateRank::rankPermutation(corners, LAST_LAYER) * 24 + StateRank::rankPermutation(edges, LAST_LAYER));
+}
+
+class Tables {
+public:
+    Tables() {
+        this->cases.push_back({ Stage::CROSS, "Cross", "" });
+        this->cases.push_back({ Stage::SOLVED, "Solved", "" });
+
+        this->buildF2L();
+        this->buildOLL();
+        this->buildPLL();
+    }
+
+    std::vector<Recognizer::Case> cases;
+    int slotSymmetries[F2L_SLOTS];      // Rotation taking each slot to FR
+    int16_t extractions[F2L_SLOTS];     // Taking the pieces out of each slot
+    int16_t f2l[F2L_SLOTS][PAIR_STATES];
+    int16_t oll[OLL_STATES];
+    int16_t pll[PLL_STATES];
+
+private:
+    void buildF2L() {
+        // Inserts the FR slot: U turns and R U R', F' U F like triggers, which only touch the slot
+        // and the last layer
+        std::vector<std::vector<Move>> triggers;
+        for (int turns = 0; turns < 3; turns++) {
+            triggers.push_back({ static_cast<Move>(static_cast<int>(Move::U) + turns) });
+
+            for (Move side: { Move::R, Move::R3, Move::F, Move::F3 }) {
+                std::vector<Move> trigger({ side, static_cast<Move>(static_cast<int>(Move::U) + turns), InverseMove(side) });
+                CubeState state;
+                state.applyMoves(trigger);
+
+                bool keepsSlots = isCrossSolved(state);
+                for (int pair = 1; pair < F2L_SLOTS; pair++) {
+                    keepsSlots = keepsSlots && isPairSolved(state, pair);
+                }
+
+                if (keepsSlots) {
+                    triggers.push_back(trigger);
+                }
+            }
+        }
+
+        // Cheapest trigger sequence to every pair position, found backwards from the solved pair
+        std::vector<std::vector<Move>> solutions(PAIR_STATES);
+        std::vector<int> costs(PAIR_STATES, -1);
+        std::vector<CubeState> states(PAIR_STATES);
+
+        typedef std::pair<int, int> Entry;  // Negated cost, pair index
+        std::priority_queue<Entry> queue;
+
+        int solved = getPairIndex(CubeState());
+        costs[solved] = 0;
+        queue.push({ 0, solved });
+
+        while (!queue.empty()) {
+            Entry entry(queue.top());
+            queue.pop();
+            if (-entry.first != costs[entry.second]) {
+                continue;
+            }
+
+            for (const auto& trigger: triggers) {
+                CubeState state(states[entry.second]);
+                state.applyMoves(trigger);
+
+                int index = getPairIndex(state);
+                int cost = costs[entry.second] + static_cast<int>(trigger.size());
+                if (costs[index] == -1 || cost < costs[index]) {
+                    std::vector<Move> solution(InverseMoves(trigger));
+                    solution.insert(solution.end(), solutions[entry.second].begin(), solutions[entry.second].end());
+
+                    costs[index] = cost;
+                    solutions[index] = solution;
+                    states[index] = state;
+                    queue.push({ -cost, index });
+                }
+            }
+        }
+
+        static const char* slotNames[F2L_SLOTS] = { "FR", "FL", "BL", "BR" };
+        static const Face slotFronts[F2L_SLOTS] = { Face::F, Face::L, Face::B, Face::R };
+        static const Face slotRights[F2L_SLOTS] = { Face::R, Face::F, Face::L, Face::B };
+
+        for (int pair = 0; pair < F2L_SLOTS; pair++) {
+            // Seeing the cube from the slot's side puts it at FR
+            int symmetry = Symmetry::inverse(Symmetry::find(Face::U, slotRights[pair], slotFronts[pair]));
+            this->slotSymmetries[pair] = symmetry;
+
+            for (int index = 0; index < PAIR_STATES; index++) {
+                if (costs[index] <= 0) {
+                    this->f2l[pair][index] = SOLVED_CASE;  // Never looked up
+                    continue;
+                }
+
+                std::vector<Move> solution;
+                for (Move move: solutions[index]) {
+                    solution.push_back(Symmetry::conjugate(Symmetry::inverse(symmetry), move));
+                }
+
+                std::string name("F2L ");
+                name += slotNames[pair];
+                name += (index / 30 == PAIR_SLOT) ? ": corner in slot" : ": corner in U";
+                name += (index % 10 / 2 == PAIR_SLOT) ? ", edge in slot" : ", edge in U";
+
+                this->f2l[pair][index] = static_cast<int16_t>(this->cases.size());
+                this->cases.push_back({ Stage::F2L, name, FormatMoves(solution) });
+            }
+
+            std::vector<Move> extraction;
+            for (Move move: ExpandAlgorithm("R U R'")) {
+                extraction.push_back(Symmetry::conjugate(Symmetry::inverse(symmetry), move));
+            }
+
+            this->extractions[pair] = static_cast<int16_t>(this->cases.size());
+            this->cases.push_back({ Stage::F2L, std::string("F2L: take the pieces out of ") + slotNames[pair], FormatMoves(extraction) });
+        }
+    }
+
+    void buildOLL() {
+        std::fill(this->oll, this->oll + OLL_STATES, static_cast<int16_t>(-1));
+        this->oll[0] = SOLVED_CASE;  // Oriented, see PLL
+
+        for (const Algorithm& algorithm: ollAlgorithms) {
+            std::vector<Move> moves(ExpandAlgorithm(algorithm.algorithm));
+
+            for (int adjustment = 0; adjustment < 4; adjustment++) {
+                CubeState state;
+                state.applyMoves(InverseMoves(moves));
+                for (int turn = 0; turn < adjustment; turn++) {
+                    state.applyMove(Move::U3);
+                }
+
+                if (!isF2LSolved(state)) {
+                    throw std::logic_error(std::string("Recognizer: ") + algorithm.name + " breaks F2L");
+                }
+
+                int index = getOllIndex(state);
+                if (this->oll[index] == -1) {
+                    this->oll[index] = static_cast<int16_t>(this->cases.size());
+                    this->cases.push_back({ Stage::OLL, algorithm.name, FormatAdjustment(adjustment, true) + algorithm.algorithm });
+                }
+            }
+        }
+    }
+
+    void buildPLL() {
+        std::fill(this->pll, this->pll + PLL_STATES, static_cast<int16_t>(-1));
+        this->pll[getPllIndex(CubeState())] = SOLVED_CASE;
+
+        for (int adjustment = 1; adjustment < 4; adjustment++) {
+            CubeState state;
+            state.applyMove(static_cast<Move>(static_cast<int>(Move::U) + 3 - adjustment));
+
+            this->pll[getPllIndex(state)] = static_cast<int16_t>(this->cases.size());
+            this->cases.push_back({ Stage::PLL, "PLL skip", MoveName(static_cast<Move>(static_cast<int>(Move::U) + adjustment - 1)) });
+        }
+
+        for (const Algorithm& algorithm: pllAlgorithms) {
+            std::vector<Move> moves(ExpandAlgorithm(algorithm.algorithm));
+
+            for (int before = 0; before < 4; before++) {
+                for (int after = 0; after < 4; after++) {
+                    CubeState state;
+                    for (int turn = 0; turn < after; turn++) {
+                        state.applyMove(Move::U3);
+                    }
+                    state.applyMoves(InverseMoves(moves));
+                    for (int turn = 0; turn < before; turn++) {
+                        state.applyMove(Move::U3);
+                    }
+
+                    if (!isF2LSolved(state) || getOllIndex(state) != 0) {
+                        throw std::logic_error(std::string("Recognizer: ") + algorithm.name + " breaks F2L or OLL");
+                    }
+
+                    int index = getPllIndex(state);
+                    if (this->pll[index] == -1) {
+                        this->pll[index] = static_cast<int16_t>(this->cases.size());
+                        this->cases.push_back({ Stage::PLL, algorithm.name,
+                                FormatAdjustment(before, true) + algorithm.algorithm + FormatAdjustment(after, false) });
+                    }
+                }
+            }
+        }
+    }
+};
+
+const Tables& getTables() {
+    static const Tables tables;
+    return tables;
+}
+
+}  // namespace
+
+Recognizer::Recognizer() {
+    getTables();  // Build tables upfront rather than on the first lookup
+}
+
+const Recognizer::Case& Recognizer::recognize(const CubeState& state) const {
+    const Tables& tables = getTables();
+    if (!isCrossSolved(state)) {
+        return tables.cases[CROSS_CASE];
+    }
+
+    int blockedPair = -1;
+    for (int pair = 0; pair < F2L_SLOTS; pair++) {
+        if (isPairSolved(state, pair)) {
+            continue;
+        }
+
+        int index = getPairIndex(Symmetry::conjugate(tables.slotSymmetries[pair], state));
+        if (index != -1) {
+            return tables.cases[tables.f2l[pair][index]];
+        }
+
+        blockedPair = (blockedPair == -1) ? pair : blockedPair;
+    }
+
+    // Every unsolved pair has a piece in another unsolved slot, free the one holding the first
+    if (blockedPair != -1) {
+        int slot = 0;
+        while (state.getCorner(FR_CORNER + slot) != FR_CORNER + blockedPair &&
+                state.getEdge(FR_EDGE + slot) != FR_EDGE + blockedPair) {
+            slot++;
+        }
+
+        return tables.cases[tables.extractions[slot]];
+    }
+
+    int oll = tables.oll[getOllIndex(state)];
+    if (oll != SOLVED_CASE) {
+        return tables.cases[oll];
+    }
+
+    return tables.cases[tables.pll[getPllIndex(state)]];
+}
+
+}  // namespace Rubik
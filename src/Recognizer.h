@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RECOGNIZER_H
+#define RECOGNIZER_H
+
+#include <CubeState.h>
+#include <string>
+
+namespace Rubik {
+
+enum class Stage { CROSS, F2L, OLL, PLL, SOLVED };
+
+// CFOP case recognition with the cross on D. Lookup tables are built once per process from the
+// algorithm lists: F2L by the position of the pair (one table, other slots are rotated onto FR),
+// OLL by the last layer twists and flips, PLL by the last layer permutation, both with the U
+// turns before and after the algorithm folded in. recognize() is a few table lookups.
+class Recognizer {
+public:
+    struct Case {
+        Stage stage;
+        std::string name;       // "F2L FR: ...", "OLL 27", "PLL T"
+        std::string algorithm;  // Including U turns to line the case up, empty if there is none
+    };
+
+    Recognizer();
+
+    const Case& recognize(const CubeState& state) const;
+};
+
+}  // namespace Rubik
+
+#endif  // RECOGNIZER_H
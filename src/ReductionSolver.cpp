@@ -0,0 +1,875 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ReductionSolver.h>
+#include <unordered_map>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+namespace Rubik {
+
+namespace {
+
+typedef std::vector<uint16_t> Permutation;  // Facelet i goes to permutation[i]
+typedef std::array<int, 3> Vector;
+
+const int SOLVE_LENGTH = 22;
+const int CENTER_DEPTH = 4;
+
+Permutation identity(size_t size) {
+    Permutation permutation(size);
+    for (size_t i = 0; i < size; i++) {
+        permutation[i] = static_cast<uint16_t>(i);
+    }
+
+    return permutation;
+}
+
+// First, then second
+Permutation compose(const Permutation& first, const Permutation& second) {
+    Permutation product(first.size());
+    for (size_t i = 0; i < first.size(); i++) {
+        product[i] = second[first[i]];
+    }
+
+    return product;
+}
+
+Permutation invert(const Permutation& permutation) {
+    Permutation inverse(permutation.size());
+    for (size_t i = 0; i < permutation.size(); i++) {
+        inverse[permutation[i]] = static_cast<uint16_t>(i);
+    }
+
+    return inverse;
+}
+
+Permutation power(const Permutation& permutation, int exponent) {
+    Permutation product(identity(permutation.size()));
+    for (int i = 0; i < exponent; i++) {
+        product = compose(product, permutation);
+    }
+
+    return product;
+}
+
+// Cubie coordinate a face pins: R, U and F sit at the far end of their axis, L, D and B at 0
+void pin(Face face, int size, Vector& cubie) {
+    int axis = 0;
+    switch (face) {
+        case Face::R: case Face::L: axis = 0; break;
+        case Face::U: case Face::D: axis = 1; break;
+        default:                    axis = 2; break;
+    }
+
+    bool positive = (face == Face::R || face == Face::U || face == Face::F);
+    cubie[axis] = positive ? size - 1 : 0;
+}
+
+// Faces of the cubie an edge or corner facelet belongs to
+int cubieFaces(const Vector& cubie, int size, Face* faces) {
+    static const Face negative[3] = { Face::L, Face::D, Face::B };
+    static const Face positive[3] = { Face::R, Face::U, Face::F };
+
+    int count = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        if (cubie[axis] == 0) {
+            faces[count++] = negative[axis];
+        } else if (cubie[axis] == size - 1) {
+            faces[count++] = positive[axis];
+        }
+    }
+
+    return count;
+}
+
+LayerMove faceMove(Move move, int size) {
+    static const uint8_t axes[6] = { 1, 0, 2, 1, 0, 2 };  // U, R, F, D, L, B
+
+    int face = static_cast<int>(MoveFace(move));
+    int turns = MoveTurns(move);
+
+    if (face < 3) {
+        return { axes[face], 0, static_cast<uint8_t>(turns) };
+    }
+
+    return { axes[face], static_cast<uint8_t>(size - 1), static_cast<uint8_t>(4 - turns) };
+}
+
+void runParallel(int jobs, int threads, const std::function<void(int)>& job) {
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int index = next++; index < jobs; index = next++) {
+            job(index);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < std::min(jobs, threads); i++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+    for (auto& thread: workers) {
+        thread.join();
+    }
+}
+
+// Same axis turns commute, so a turn merges into any earlier one of its layer within the run
+void appendMove(std::vector<LayerMove>& moves, const LayerMove& move) {
+    for (auto layerMove = moves.rbegin(); layerMove != moves.rend() && layerMove->axis == move.axis; layerMove++) {
+        if (layerMove->layer == move.layer) {
+            layerMove->turns = static_cast<uint8_t>((layerMove->turns + move.turns) % 4);
+            if (layerMove->turns == 0) {
+                moves.erase(std::next(layerMove).base());
+            }
+            return;
+        }
+    }
+
+    moves.push_back(move);
+}
+
+}  // namespace
+
+class ReductionSolver::Tables {
+public:
+    // Sequences are either stored as is (parent -1) or conjugate their parent: move', parent, move
+    struct Cycle {
+        int parent;
+        LayerMove move;
+        int offset;
+        int length;
+    };
+
+    // Pieces of one orbit, centers or one facelet of each wing. Cycles are indexed by the slots
+    // a, b and c of a 3-cycle taking the piece at a to b, the one at b to c and the one at c to a.
+    struct Orbit {
+        std::vector<int> facelets;
+        std::vector<int> partners;  // The other facelet of wings, -1 for centers
+        std::vector<int> homes;     // Face of centers, edge slot * 2 + edge facelet of wings
+        std::vector<int> cycleIndex;
+        std::vector<Cycle> cycles;
+        std::vector<LayerMove> baseMoves;
+    };
+
+    explicit Tables(int size, int threads);
+
+    void expand(const Orbit& orbit, int cycle, std::vector<LayerMove>& moves) const;
+    bool reduce(const Orbit& orbit, std::vector<int>& values, const std::vector<int>& targets, std::vector<LayerMove>& moves) const;
+    bool fixCenters(BigCube& cube, std::vector<LayerMove>& moves, int depth) const;
+
+    int size;
+    BigCube cube;
+
+    // Layers 0 to size - 2 of every axis, the DBL corner never moves
+    std::vector<LayerMove> generators;
+    std::vector<Permutation> generatorTurns;
+    std::vector<Orbit> orbits;
+
+    std::vector<Permutation> rotations;
+    std::vector<std::vector<LayerMove>> frames;  // Rotated frame move (axis * size + layer) * 3 + turns - 1 as seen unrotated
+
+private:
+    void findOrbits();
+    void findCycles();
+    void closeCycles(Orbit& orbit);
+    void findRotations();
+    void addCycle(Orbit& orbit, int a, int b, int c, const Cycle& cycle);
+
+    std::vector<int> faceletOrbits;
+    std::vector<int> faceletSlots;
+};
+
+ReductionSolver::Tables::Tables(int size, int threads):
+        size(size),
+        cube(size) {
+    for (int axis = 0; axis < 3; axis++) {
+        for (int layer = 0; layer < size - 1; layer++) {
+            for (int turns = 1; turns <= 3; turns++) {
+                this->generators.push_back({ static_cast<uint8_t>(axis), static_cast<uint8_t>(layer), static_cast<uint8_t>(turns) });
+                this->generatorTurns.push_back(power(this->cube.getTurn(axis, layer), turns));
+            }
+        }
+    }
+
+    this->findOrbits();
+    this->findCycles();
+    runParallel(static_cast<int>(this->orbits.size()), threads, [this](int orbit) {
+        this->closeCycles(this->orbits[orbit]);
+    });
+    this->findRotations();
+}
+
+void ReductionSolver::Tables::findOrbits() {
+    int facelets = this->cube.getFacelets();
+    std::vector<int> roots(facelets);
+    for (int facelet = 0; facelet < facelets; facelet++) {
+        roots[facelet] = facelet;
+    }
+
+    std::function<int(int)> find = [&roots, &find](int facelet) {
+        return (roots[facelet] == facelet) ? facelet : (roots[facelet] = find(roots[facelet]));
+    };
+
+    for (size_t generator = 0; generator < this->generators.size(); generator += 3) {
+        for (int facelet = 0; facelet < facelets; facelet++) {
+            int first = find(facelet);
+            int second = find(this->generatorTurns[generator][facelet]);
+            roots[std::max(first, second)] = std::min(first, second);
+        }
+    }
+
+    int middle = (this->size % 2 == 1) ? this->size / 2 : -1;
+    std::unordered_map<int, int> orbitIndex;
+    this->faceletOrbits.assign(facelets, -1);
+    this->faceletSlots.assign(facelets, -1);
+
+    for (int facelet = 0; facelet < facelets; facelet++) {
+        Vector cubie = this->cube.getFaceletCubie(facelet);
+        Face faces[3];
+        int count = cubieFaces(cubie, this->size, faces);
+
+        int partner = -1;
+        int home = static_cast<int>(this->cube.getFaceletFace(facelet));
+
+        if (count == 1) {
+            // Fixed centers sit in the middle of both other axes
+            int inner = 0;
+            for (int axis = 0; axis < 3; axis++) {
+                inner += (cubie[axis] == middle) ? 1 : 0;
+            }
+
+            if (inner == 2) {
+                continue;
+            }
+        } else if (count == 2) {
+            int along = (cubie[0] != 0 && cubie[0] != this->size - 1) ? 0 : (cubie[1] != 0 && cubie[1] != this->size - 1) ? 1 : 2;
+            if (cubie[along] == middle) {
+                continue;  // Middle edges are left for the reduced cube
+            }
+
+            Face face = this->cube.getFaceletFace(facelet);
+            Face other = (faces[0] == face) ? faces[1] : faces[0];
+            partner = this->cube.findFacelet(other, cubie[0], cubie[1], cubie[2]);
+
+            // Wings can't flip, their two facelets are in different orbits: track the first one
+            if (find(partner) < find(facelet)) {
+                continue;
+            }
+
+            for (int edge = 0; edge < CubeState::EDGES; edge++) {
+                for (int edgeFacelet = 0; edgeFacelet < 2; edgeFacelet++) {
+                    if (CubeState::getEdgeFacelet(edge, edgeFacelet) == face && CubeState::getEdgeFacelet(edge, 1 - edgeFacelet) == other) {
+                        home = edge * 2 + edgeFacelet;
+                    }
+                }
+            }
+        } else {
+            continue;  // Corners belong to the reduced cube
+        }
+
+        auto inserted = orbitIndex.emplace(find(facelet), static_cast<int>(this->orbits.size()));
+        if (inserted.second) {
+            this->orbits.emplace_back();
+        }
+
+        Orbit& orbit = this->orbits[inserted.first->second];
+        this->faceletOrbits[facelet] = inserted.first->second;
+        this->faceletSlots[facelet] = static_cast<int>(orbit.facelets.size());
+
+        orbit.facelets.push_back(facelet);
+        orbit.partners.push_back(partner);
+        orbit.homes.push_back(home);
+    }
+
+    for (auto& orbit: this->orbits) {
+        size_t slots = orbit.facelets.size();
+        orbit.cycleIndex.assign(slots * slots * slots, -1);
+    }
+}
+
+// Commutators [s f s', t] cycle centers and [s, f g f'] cycle wings, s and t being inner layers
+// and f and g outer ones. Whichever happen to move exactly three pieces of one orbit are kept.
+void ReductionSolver::Tables::findCycles() {
+    if (this->orbits.empty()) {
+        return;
+    }
+
+    std::vector<int> inner;
+    std::vector<int> outer;
+    for (size_t generator = 0; generator < this->generators.size(); generator++) {
+        (this->generators[generator].layer == 0 ? outer : inner).push_back(static_cast<int>(generator));
+    }
+
+    std::vector<Permutation> inverses;
+    for (auto& turn: this->generatorTurns) {
+        inverses.push_back(invert(turn));
+    }
+
+    auto record = [this](const Permutation& permutation, const std::vector<int>& sequence) {
+        std::vector<int> moved;
+        for (size_t facelet = 0; facelet < permutation.size() && moved.size() <= 6; facelet++) {
+            if (permutation[facelet] != facelet) {
+                moved.push_back(static_cast<int>(facelet));
+            }
+        }
+
+        if (moved.size() != 3 && moved.size() != 6) {
+            return;
+        }
+
+        int tracked = -1;
+        int pieces = 0;
+        for (int facelet: moved) {
+            if (this->faceletOrbits[facelet] != -1) {
+                if (tracked != -1 && this->faceletOrbits[facelet] != this->faceletOrbits[tracked]) {
+                    return;
+                }
+
+                tracked = facelet;
+                pieces++;
+            }
+        }
+
+        if (pieces != 3) {
+            return;
+        }
+
+        Orbit& orbit = this->orbits[this->faceletOrbits[tracked]];
+        if (moved.size() != (orbit.partners[this->faceletSlots[tracked]] == -1 ? 3u : 6u)) {
+            return;
+        }
+
+        int a = this->faceletSlots[tracked];
+        int b = this->faceletSlots[permutation[tracked]];
+        int c = this->faceletSlots[permutation[permutation[tracked]]];
+        if (a == -1 || b == -1 || c == -1) {
+            return;
+        }
+
+        size_t slots = orbit.facelets.size();
+        if (orbit.cycleIndex[(a * slots + b) * slots + c] != -1) {
+            return;
+        }
+
+        int length = static_cast<int>(sequence.size());
+        int offset = static_cast<int>(orbit.baseMoves.size());
+        for (int generator: sequence) {
+            orbit.baseMoves.push_back(this->generators[generator]);
+        }
+        this->addCycle(orbit, a, b, c, { -1, {}, offset, length });
+
+        // The inverse runs the other way round
+        offset = static_cast<int>(orbit.baseMoves.size());
+        for (auto generator = sequence.rbegin(); generator != sequence.rend(); generator++) {
+            orbit.baseMoves.push_back(InverseLayerMove(this->generators[*generator]));
+        }
+        this->addCycle(orbit, a, c, b, { -1, {}, offset, length });
+    };
+
+    auto inverseOf = [this](int generator) {
+        return generator - this->generators[generator].turns + 4 - this->generators[generator].turns;
+    };
+
+    for (int s: inner) {
+        for (int f: outer) {
+            Permutation conjugate(compose(compose(this->generatorTurns[s], this->generatorTurns[f]), inverses[s]));
+            Permutation conjugateInverse(invert(conjugate));
+
+            for (int t: inner) {
+                Permutation commutator(compose(compose(compose(conjugate, this->generatorTurns[t]), conjugateInverse), inverses[t]));
+                record(commutator, { s, f, inverseOf(s), t, s, inverseOf(f), inverseOf(s), inverseOf(t) });
+            }
+        }
+    }
+
+    for (int f: outer) {
+        for (int g: outer) {
+            if (this->generators[f].axis == this->generators[g].axis) {
+                continue;
+            }
+
+            Permutation conjugate(compose(compose(this->generatorTurns[f], this->generatorTurns[g]), inverses[f]));
+            Permutation conjugateInverse(invert(conjugate));
+
+            for (int s: inner) {
+                Permutation commutator(compose(compose(compose(this->generatorTurns[s], conjugate), inverses[s]), conjugateInverse));
+                record(commutator, { s, f, g, inverseOf(f), inverseOf(s), f, inverseOf(g), inverseOf(f) });
+            }
+        }
+    }
+}
+
+// Conjugating a 3-cycle by a turn cycles the slots that turn leads to, breadth first gives every
+// 3-cycle of the orbit with the fewest setup turns
+void ReductionSolver::Tables::closeCycles(Orbit& orbit) {
+    size_t slots = orbit.facelets.size();
+    std::vector<std::vector<int>> turns(this->generators.size(), std::vector<int>(slots));
+
+    for (size_t generator = 0; generator < this->generators.size(); generator++) {
+        for (size_t slot = 0; slot < slots; slot++) {
+            turns[generator][slot] = this->faceletSlots[this->generatorTurns[generator][orbit.facelets[slot]]];
+        }
+    }
+
+    // Slots of every cycle, kept aside as the index only maps slots to cycles
+    std::vector<std::array<int, 3>> cycleSlots(orbit.cycles.size());
+    for (size_t key = 0; key < orbit.cycleIndex.size(); key++) {
+        int cycle = orbit.cycleIndex[key];
+        if (cycle != -1) {
+            int a = static_cast<int>(key / (slots * slots));
+            if (a == static_cast<int>(std::min({ key / (slots * slots), key / slots % slots, key % slots }))) {
+                cycleSlots[cycle] = {{ a, static_cast<int>(key / slots % slots), static_cast<int>(key % slots) }};
+            }
+        }
+    }
+
+    for (size_t cycle = 0; cycle < orbit.cycles.size(); cycle++) {
+        for (size_t generator = 0; generator < this->generators.size(); generator++) {
+            std::array<int, 3> from = cycleSlots[cycle];
+            int a = turns[generator][from[0]];
+            int b = turns[generator][from[1]];
+            int c = turns[generator][from[2]];
+
+            if (orbit.cycleIndex[(a * slots + b) * slots + c] == -1) {
+                this->addCycle(orbit, a, b, c, {
+                    static_cast<int>(cycle), this->generators[generator], 0, orbit.cycles[cycle].length + 2
+                });
+                cycleSlots.push_back({{ a, b, c }});
+            }
+        }
+    }
+}
+
+void ReductionSolver::Tables::addCycle(Orbit& orbit, int a, int b, int c, const Cycle& cycle) {
+    size_t slots = orbit.facelets.size();
+    int index = static_cast<int>(orbit.cycles.size());
+
+    orbit.cycles.push_back(cycle);
+    orbit.cycleIndex[(a * slots + b) * slots + c] = index;
+    orbit.cycleIndex[(b * slots + c) * slots + a] = index;
+    orbit.cycleIndex[(c * slots + a) * slots + b] = index;
+}
+
+void ReductionSolver::Tables::findRotations() {
+    int facelets = this->cube.getFacelets();
+    Permutation wholeTurns[3];
+
+    for (int axis = 0; axis < 3; axis++) {
+        wholeTurns[axis] = identity(facelets);
+        for (int layer = 0; layer < this->size; layer++) {
+            wholeTurns[axis] = compose(wholeTurns[axis], this->cube.getTurn(axis, layer));
+        }
+    }
+
+    this->rotations.push_back(identity(facelets));
+    for (size_t rotation = 0; rotation < this->rotations.size(); rotation++) {
+        for (int axis = 0; axis < 3; axis++) {
+            Permutation next(compose(this->rotations[rotation], wholeTurns[axis]));
+            if (std::find(this->rotations.begin(), this->rotations.end(), next) == this->rotations.end()) {
+                this->rotations.push_back(next);
+            }
+        }
+    }
+
+    std::vector<Permutation> moves;
+    for (int axis = 0; axis < 3; axis++) {
+        for (int layer = 0; layer < this->size; layer++) {
+            for (int turns = 1; turns <= 3; turns++) {
+                moves.push_back(power(this->cube.getTurn(axis, layer), turns));
+            }
+        }
+    }
+
+    // A turn applied to the rotated cube is the rotation, the turn and the rotation back
+    for (auto& rotation: this->rotations) {
+        Permutation inverse(invert(rotation));
+        std::vector<LayerMove> frame(moves.size());
+
+        for (size_t move = 0; move < moves.size(); move++) {
+            Permutation conjugate(compose(compose(rotation, moves[move]), inverse));
+            size_t match = std::find(moves.begin(), moves.end(), conjugate) - moves.begin();
+
+            frame[move] = {
+                static_cast<uint8_t>(match / (3 * this->size)),
+                static_cast<uint8_t>(match / 3 % this->size),
+                static_cast<uint8_t>(match % 3 + 1)
+            };
+        }
+
+        this->frames.push_back(frame);
+    }
+}
+
+void ReductionSolver::Tables::expand(const Orbit& orbit, int cycle, std::vector<LayerMove>& moves) const {
+    const Cycle& entry = orbit.cycles[cycle];
+    if (entry.parent == -1) {
+        moves.insert(moves.end(), orbit.baseMoves.begin() + entry.offset, orbit.baseMoves.begin() + entry.offset + entry.length);
+        return;
+    }
+
+    moves.push_back(InverseLayerMove(entry.move));
+    this->expand(orbit, entry.parent, moves);
+    moves.push_back(entry.move);
+}
+
+// Slot by slot, each time picking the shortest 3-cycle that brings a matching piece over from an
+// unsolved slot and, when there is a choice, also puts the other two pieces right
+bool ReductionSolver::Tables::reduce(const Orbit& orbit, std::vector<int>& values,
+        const std::vector<int>& targets, std::vector<LayerMove>& moves) const {
+    int slots = static_cast<int>(orbit.facelets.size());
+    std::vector<bool> locked(slots, false);
+
+    for (int t = 0; t < slots; t++) {
+        if (values[t] == targets[t]) {
+            locked[t] = true;
+            continue;
+        }
+
+        int best = -1;
+        int bestA = 0, bestC = 0, bestScore = -1;
+
+        for (int a = 0; a < slots; a++) {
+            if (locked[a] || a == t || values[a] != targets[t]) {
+                continue;
+            }
+
+            for (int c = 0; c < slots; c++) {
+                // A solved slot may take part as long as it gets an equal piece back
+                if (c == a || c == t || (locked[c] && values[t] != targets[c])) {
+                    continue;
+                }
+
+                int cycle = orbit.cycleIndex[(a * slots + t) * slots + c];
+                if (cycle == -1) {
+                    continue;
+                }
+
+                int score = ((values[t] == targets[c]) ? 1 : 0) + ((values[c] == targets[a]) ? 1 : 0);
+                if (score > bestScore || (score == bestScore && orbit.cycles[cycle].length < orbit.cycles[best].length)) {
+                    best = cycle;
+                    bestA = a;
+                    bestC = c;
+                    bestScore = score;
+                }
+            }
+        }
+
+        if (best == -1) {
+            return false;
+        }
+
+        int value = values[bestC];
+        values[bestC] = values[t];
+        values[t] = values[bestA];
+        values[bestA] = value;
+
+        this->expand(orbit, best, moves);
+        locked[t] = true;
+    }
+
+    return true;
+}
+
+bool ReductionSolver::Tables::fixCenters(BigCube& cube, std::vector<LayerMove>& moves, int depth) const {
+    int middle = this->size / 2;
+    bool solved = true;
+
+    for (int face = 0; face < 6 && solved; face++) {
+        int facelet = face * this->size * this->size + middle * this->size + middle;
+        solved = (cube.getFacelet(facelet) == static_cast<Face>(face));
+    }
+
+    if (solved) {
+        return true;
+    }
+
+    if (depth == 0) {
+        return false;
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (!moves.empty() && moves.back().axis == axis) {
+            continue;
+        }
+
+        for (int turns = 1; turns <= 3; turns++) {
+            LayerMove move = { static_cast<uint8_t>(axis), static_cast<uint8_t>(middle), static_cast<uint8_t>(turns) };
+            BigCube turned(cube);
+            turned.applyMove(move);
+            moves.push_back(move);
+
+            if (this->fixCenters(turned, moves, depth - 1)) {
+                cube = turned;
+                return true;
+            }
+
+            moves.pop_back();
+        }
+    }
+
+    return false;
+}
+
+ReductionSolver::ReductionSolver(int size):
+        threads(std::max(1u, std::thread::hardware_concurrency())) {
+    static std::unordered_map<int, std::shared_ptr<const Tables>> tables;
+    static std::mutex tablesMutex;
+
+    std::lock_guard<std::mutex> lock(tablesMutex);
+    auto& sizeTables = tables[size];
+    if (!sizeTables) {
+        BigCube cube(size);  // Validates the size
+        sizeTables = std::make_shared<Tables>(size, this->threads);
+    }
+
+    this->tables = sizeTables;
+}
+
+int ReductionSolver::getSize() const {
+    return this->tables->size;
+}
+
+int ReductionSolver::getThreads() const {
+    return this->threads;
+}
+
+void ReductionSolver::setThreads(int threads) {
+    this->threads = std::max(threads, 1);
+}
+
+bool ReductionSolver::solve(const BigCube& cube, std::vector<LayerMove>& solution) const {
+    const Tables& tables = *this->tables;
+    int size = tables.size;
+
+    if (cube.getSize() != size) {
+        throw std::invalid_argument("solve(): cube size mismatch");
+    }
+
+    /* Turn the whole cube so that the DBL corner is home, its colors fix those of every face */
+
+    BigCube state(size);
+    int rotation = 0;
+    int corner[3] = {
+        state.findFacelet(Face::D, 0, 0, 0), state.findFacelet(Face::B, 0, 0, 0), state.findFacelet(Face::L, 0, 0, 0)
+    };
+
+    for (; rotation < static_cast<int>(tables.rotations.size()); rotation++) {
+        const Permutation& turn = tables.rotations[rotation];
+        for (int facelet = 0; facelet < cube.getFacelets(); facelet++) {
+            state.setFacelet(turn[facelet], cube.getFacelet(facelet));
+        }
+
+        if (state.getFacelet(corner[0]) == Face::D && state.getFacelet(corner[1]) == Face::B && state.getFacelet(corner[2]) == Face::L) {
+            break;
+        }
+    }
+
+    if (rotation == static_cast<int>(tables.rotations.size())) {
+        return false;
+    }
+
+    std::vector<LayerMove> moves;
+    if (size % 2 == 1 && !tables.fixCenters(state, moves, CENTER_DEPTH)) {
+        return false;
+    }
+
+    /* The reduced cube: corners as they are, edges as the wings are going to be paired */
+
+    CubeState reduced;
+    Face edgeColors[CubeState::EDGES][2];
+
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        Vector cubie = {{ 0, 0, 0 }};
+        Face colors[3];
+        for (int facelet = 0; facelet < 3; facelet++) {
+            pin(CubeState::getCornerFacelet(slot, facelet), size, cubie);
+        }
+
+        for (int facelet = 0; facelet < 3; facelet++) {
+            colors[facelet] = state.getFacelet(state.findFacelet(CubeState::getCornerFacelet(slot, facelet), cubie[0], cubie[1], cubie[2]));
+        }
+
+        for (int piece = 0; piece < CubeState::CORNERS; piece++) {
+            for (int orientation = 0; orientation < 3; orientation++) {
+                if (colors[0] == CubeState::getCornerFacelet(piece, (3 - orientation) % 3) &&
+                        colors[1] == CubeState::getCornerFacelet(piece, (4 - orientation) % 3) &&
+                        colors[2] == CubeState::getCornerFacelet(piece, (5 - orientation) % 3)) {
+                    reduced.setCorner(slot, piece, orientation);
+                }
+            }
+        }
+    }
+
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        int edge = slot;
+        int orientation = 0;
+
+        if (size % 2 == 1) {
+            int middle = size / 2;
+            Vector cubie = {{ middle, middle, middle }};
+            pin(CubeState::getEdgeFacelet(slot, 0), size, cubie);
+            pin(CubeState::getEdgeFacelet(slot, 1), size, cubie);
+
+            Face colors[2];
+            for (int facelet = 0; facelet < 2; facelet++) {
+                colors[facelet] = state.getFacelet(state.findFacelet(CubeState::getEdgeFacelet(slot, facelet), cubie[0], cubie[1], cubie[2]));
+            }
+
+            for (int piece = 0; piece < CubeState::EDGES; piece++) {
+                for (int flip = 0; flip < 2; flip++) {
+                    if (colors[0] == CubeState::getEdgeFacelet(piece, flip) && colors[1] == CubeState::getEdgeFacelet(piece, 1 - flip)) {
+                        edge = piece;
+                        orientation = flip;
+                    }
+                }
+            }
+        } else if (slot < 2 && reduced.getCornerParity() == 1) {
+            edge = 1 - slot;  // Pair UR and UF wings swapped, no PLL parity then
+        }
+
+        reduced.setEdge(slot, edge, orientation);
+        edgeColors[slot][0] = CubeState::getEdgeFacelet(edge, orientation);
+        edgeColors[slot][1] = CubeState::getEdgeFacelet(edge, 1 - orientation);
+    }
+
+    if (!reduced.isValid()) {
+        return false;
+    }
+
+    /* 3-cycles keep the permutation parity, wing orbits that are off get a slice quarter turn */
+
+    std::vector<std::vector<int>> values(tables.orbits.size());
+    std::vector<std::vector<int>> targets(tables.orbits.size());
+
+    auto readOrbit = [&](int orbitIndex) {
+        const Tables::Orbit& orbit = tables.orbits[orbitIndex];
+        std::vector<int>& orbitValues = values[orbitIndex];
+        std::vector<int>& orbitTargets = targets[orbitIndex];
+        orbitValues.resize(orbit.facelets.size());
+        orbitTargets.resize(orbit.facelets.size());
+
+        for (size_t slot = 0; slot < orbit.facelets.size(); slot++) {
+            orbitValues[slot] = static_cast<int>(state.getFacelet(orbit.facelets[slot]));
+            orbitTargets[slot] = orbit.homes[slot];
+
+            if (orbit.partners[slot] != -1) {
+                int edge = orbit.homes[slot] / 2;
+                int facelet = orbit.homes[slot] % 2;
+                orbitValues[slot] = orbitValues[slot] * 6 + static_cast<int>(state.getFacelet(orbit.partners[slot]));
+                orbitTargets[slot] = static_cast<int>(edgeColors[edge][facelet]) * 6 + static_cast<int>(edgeColors[edge][1 - facelet]);
+            }
+        }
+    };
+
+    for (size_t orbitIndex = 0; orbitIndex < tables.orbits.size(); orbitIndex++) {
+        const Tables::Orbit& orbit = tables.orbits[orbitIndex];
+        if (orbit.partners[0] == -1) {
+            continue;
+        }
+
+        readOrbit(static_cast<int>(orbitIndex));
+        size_t slots = orbit.facelets.size();
+        std::vector<int> sources(slots, -1);
+
+        for (size_t slot = 0; slot < slots; slot++) {
+            auto source = std::find(values[orbitIndex].begin(), values[orbitIndex].end(), targets[orbitIndex][slot]);
+            if (source == values[orbitIndex].end() || sources[source - values[orbitIndex].begin()] != -1) {
+                return false;  // Wings of one orbit are all different
+            }
+            sources[source - values[orbitIndex].begin()] = static_cast<int>(slot);
+        }
+
+        size_t cycles = 0;
+        for (size_t slot = 0; slot < slots; slot++) {
+            if (sources[slot] != -1) {
+                cycles++;
+                for (size_t next = slot; sources[next] != -1;) {
+                    size_t following = sources[next];
+                    sources[next] = -1;
+                    next = following;
+                }
+            }
+        }
+
+        if ((slots - cycles) % 2 == 1) {
+            Vector cubie = state.getFaceletCubie(orbit.facelets[0]);
+            int along = (cubie[0] != 0 && cubie[0] != size - 1) ? 0 : (cubie[1] != 0 && cubie[1] != size - 1) ? 1 : 2;
+            LayerMove slice = { static_cast<uint8_t>(along), static_cast<uint8_t>(size - 1 - cubie[along]), 1 };
+            state.applyMove(slice);
+            moves.push_back(slice);
+        }
+    }
+
+    /* Centers, wings and the reduced cube, independent of each other */
+
+    int jobs = static_cast<int>(tables.orbits.size()) + 1;
+    std::vector<std::vector<LayerMove>> phases(jobs);
+    std::vector<char> solved(jobs, 0);
+
+    runParallel(jobs, this->threads, [&](int job) {
+        if (job < static_cast<int>(tables.orbits.size())) {
+            readOrbit(job);
+            solved[job] = tables.reduce(tables.orbits[job], values[job], targets[job], phases[job]);
+            return;
+        }
+
+        std::vector<Move> faceMoves;
+        if (!this->solver.solve(reduced, SOLVE_LENGTH, faceMoves)) {
+            this->solver.solve(reduced, Solver::MAX_LENGTH, faceMoves);
+        }
+
+        for (Move move: faceMoves) {
+            phases[job].push_back(faceMove(move, size));
+        }
+        solved[job] = 1;
+    });
+
+    if (std::find(solved.begin(), solved.end(), 0) != solved.end()) {
+        return false;
+    }
+
+    std::vector<LayerMove> rotated;
+    for (auto& move: moves) {
+        appendMove(rotated, move);
+    }
+
+    for (auto& phase: phases) {
+        for (auto& move: phase) {
+            appendMove(rotated, move);
+        }
+    }
+
+    solution.clear();
+    for (auto& move: rotated) {
+        solution.push_back(tables.frames[rotation][(move.axis * size + move.layer) * 3 + move.turns - 1]);
+    }
+
+    return true;
+}
+
+}  // namespace Rubik
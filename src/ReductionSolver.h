@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef REDUCTIONSOLVER_H
+#define REDUCTIONSOLVER_H
+
+#include <BigCube.h>
+#include <Solver.h>
+#include <vector>
+#include <memory>
+
+namespace Rubik {
+
+// Reduction solver for NxN cubes. The cube is turned so that its DBL corner is home, which fixes
+// the color scheme even without fixed centers, and the wing pairing is chosen so that the reduced
+// cube has no parity. Centers and wings are then solved orbit by orbit with pure 3-cycles and the
+// reduced cube with the two-phase solver. 3-cycles never disturb other orbits, so all those phases
+// run side by side. Tables are built once per size and shared by all instances.
+class ReductionSolver {
+public:
+    explicit ReductionSolver(int size);
+
+    int getSize() const;
+
+    int getThreads() const;
+    void setThreads(int threads);
+
+    bool solve(const BigCube& cube, std::vector<LayerMove>& solution) const;
+
+private:
+    class Tables;
+
+    std::shared_ptr<const Tables> tables;
+    Solver solver;
+    int threads;
+};
+
+}  // namespace Rubik
+
+#endif  // REDUCTIONSOLVER_H
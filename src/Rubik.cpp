@@ -21,6 +21,8 @@
  */
 
 #include <Rubik.h>
+#include <AllocationCounter.h>
+#include <Symmetry.h>
 #include <ObjectManager.h>
 #include <RenderManager.h>
 #include <RenderState.h>
@@ -30,56 +32,174 @@
 #include <ObjectGroup.h>
 #include <TextComponent.h>
 #include <Layout.h>
+#include <Vec3.h>
 #include <sstream>
-#include <iomanip>
+#include <iostream>
 #include <algorithm>
-#include <cmath>
-#include <ctime>
+#include <cstdarg>
 #include <cstdlib>
+#include <cwchar>
+#include <ctime>
 
 namespace Rubik {
 
-Rubik::Rubik() {
-    std::srand(static_cast<int>(std::time(nullptr)));
+// The forward shader handles one directed light, anything more goes through the G-buffer
+static const int FORWARD_LIGHTS = 1;
+static const float AMBIENT_ENERGY = 0.2f;
+static const Math::Vec3 PLAYER_POSITION(0.25f, -0.25f, -4.5f);
+
+// Characters a label holds at most and scratch memory formatting them takes per frame
+static const size_t LABEL_LENGTH = 256;
+static const size_t SOLVE_TIME_LENGTH = 16;
+static const size_t FRAME_ARENA_SIZE = 32768;
+
+static unsigned int GetGameKey(Graphene::KeyboardKey key) {
+    switch (key) {
+        case Graphene::KeyboardKey::KEY_S:
+            return KEY_SPEEDUP;
+
+        case Graphene::KeyboardKey::KEY_P:
+            return KEY_PAUSE;
+
+        case Graphene::KeyboardKey::KEY_ESCAPE:
+            return KEY_QUIT;
+
+        case Graphene::KeyboardKey::KEY_Y:
+            return KEY_YES;
+
+        case Graphene::KeyboardKey::KEY_N:
+            return KEY_NO;
+
+        default:
+            return 0;
+    }
+}
+
+// Solve time as m:ss.cc, a dash while there is nothing to show
+static void FormatSolveTime(float time, wchar_t* text, size_t size) {
+    if (time < 0.0f) {
+        std::swprintf(text, size, L"-");
+        return;
+    }
+
+    int centiseconds = static_cast<int>(time * 100.0f + 0.5f);
+    std::swprintf(text, size, L"%d:%02d.%02d", centiseconds / 6000, centiseconds / 100 % 60, centiseconds % 100);
+}
+
+Rubik::Rubik():
+        frameArena(FRAME_ARENA_SIZE) {
+    this->setSeed(static_cast<uint64_t>(std::time(nullptr)));
 }
 
 int Rubik::getShuffles() const {
-    return this->shuffles;
+    return this->simulation.getShuffles();
 }
 
 void Rubik::setShuffles(int shuffles) {
-    this->shuffles = shuffles;
+    this->simulation.setShuffles(shuffles);
+}
+
+bool Rubik::isRandomState() const {
+    return this->simulation.isRandomState();
+}
+
+void Rubik::setRandomState(bool randomState) {
+    this->simulation.setRandomState(randomState);
+}
+
+SolveLog& Rubik::getSolveLog() {
+    return this->simulation.getSolveLog();
+}
+
+const std::string& Rubik::getSessionPath() const {
+    return this->simulation.getSessionPath();
+}
+
+void Rubik::setSessionPath(const std::string& sessionPath) {
+    this->simulation.setSessionPath(sessionPath);
+}
+
+uint64_t Rubik::getSeed() const {
+    return this->simulation.getSeed();
+}
+
+void Rubik::setSeed(uint64_t seed) {
+    this->simulation.setSeed(seed);
+}
+
+RenderMode Rubik::getRenderMode() const {
+    return this->renderMode;
+}
+
+void Rubik::setRenderMode(RenderMode renderMode) {
+    this->renderMode = renderMode;
+}
+
+bool Rubik::isTraining() const {
+    return this->training;
+}
+
+void Rubik::setTraining(bool training) {
+    this->training = training;
+}
+
+bool Rubik::isFxaa() const {
+    return this->fxaa;
+}
+
+void Rubik::setFxaa(bool fxaa) {
+    this->fxaa = fxaa;
+}
+
+bool Rubik::isDebug() const {
+    return this->debug;
+}
+
+void Rubik::setDebug(bool debug) {
+    this->debug = debug;
+    AllocationCounter::setEnabled(debug);
+}
+
+const std::shared_ptr<ShaderCache>& Rubik::getShaderCache() const {
+    return this->shaderCache;
+}
+
+void Rubik::setShaderCache(const std::shared_ptr<ShaderCache>& shaderCache) {
+    this->shaderCache = shaderCache;
 }
 
 void Rubik::onMouseMotion(int x, int y) {
     static Graphene::MousePosition mousePosition(this->getWindow()->getMousePosition());
     const Graphene::MouseState& mouseState = this->getWindow()->getMouseState();
+    const GameSnapshot& snapshot = this->simulation.getSnapshot();
 
-    Math::Vec3 motionDirection(static_cast<float>(x - mousePosition.first), static_cast<float>(y - mousePosition.second), 0.0f);
+    float xDirection = static_cast<float>(x - mousePosition.first);
+    float yDirection = static_cast<float>(y - mousePosition.second);
     mousePosition = this->getWindow()->getMousePosition();
 
     int objectId = -1;
     bool isCubeSelected = false;
     bool isFrontCubeSelected = false;
 
-    switch (this->state) {
+    switch (snapshot.state) {
         case GameState::RUNNING:
             if (mouseState[Graphene::MouseButton::BUTTON_LEFT] || mouseState[Graphene::MouseButton::BUTTON_RIGHT]) {
                 int pickupX = x * this->pickupBuffer->getWidth() / this->getWindow()->getWidth();
-                int pickupY = (this->getWindow()->getHeight() - y) * this->pickupBuffer->getHeight() / this->getWindow()->getHeight();
+                int pickupY = (this->getWindow()->getHeight() - 1 - y) * this->pickupBuffer->getHeight() / this->getWindow()->getHeight();
                 this->pickupBuffer->getPixel(pickupX, pickupY, GL_RED_INTEGER, GL_INT, &objectId);
 
-                isCubeSelected = (std::find(this->puzzleObjects.begin(), this->puzzleObjects.end(), objectId) != this->puzzleObjects.end());
-                isFrontCubeSelected = (isCubeSelected && std::get<2>(this->puzzle->getCubePosition(objectId)) == 0);
+                auto cube = std::find(this->puzzleObjects.begin(), this->puzzleObjects.end(), objectId);
+                isCubeSelected = (cube != this->puzzleObjects.end());
+                isFrontCubeSelected = (isCubeSelected && snapshot.positions[cube - this->puzzleObjects.begin()] % 3 == 0);
             }
 
             if (mouseState[Graphene::MouseButton::BUTTON_LEFT] && !mouseState[Graphene::MouseButton::BUTTON_RIGHT]) {
                 if (isFrontCubeSelected) {
-                    this->rotateCube(objectId, motionDirection);
+                    this->simulation.rotateCube(objectId, xDirection, yDirection);
                 }
             } else if (mouseState[Graphene::MouseButton::BUTTON_RIGHT] && !mouseState[Graphene::MouseButton::BUTTON_LEFT]) {
                 if (isCubeSelected) {
-                    this->rotateCube(-1, motionDirection);
+                    this->simulation.rotateCube(-1, xDirection, yDirection);
                 }
             }
             break;
@@ -90,43 +210,23 @@ void Rubik::onMouseMotion(int x, int y) {
 }
 
 void Rubik::onKeyboardKey(Graphene::KeyboardKey key, bool state) {
-    static bool pausePressed = false;
-    static float rotationSpeed = 0.0f;
-
-    switch (this->state) {
-        case GameState::RUNNING:
-            if (key == Graphene::KeyboardKey::KEY_S) {
-                if (state) {
-                    if (rotationSpeed == 0.0f) {
-                        rotationSpeed = this->puzzle->getRotationSpeed();
-                        this->puzzle->setRotationSpeed(rotationSpeed * 2.0f);
-                    }
-                } else {
-                    this->puzzle->setRotationSpeed(rotationSpeed);
-                    rotationSpeed = 0.0f;
-                }
-            }
-            // Fall through
-
-        case GameState::PAUSED:
-            if (key == Graphene::KeyboardKey::KEY_P) {
-                if (state) {
-                    if (!pausePressed) {
-                        this->state = (this->state == GameState::RUNNING) ? GameState::PAUSED : GameState::RUNNING;
-                        pausePressed = true;
-                    }
-                } else {
-                    pausePressed = false;
-                }
-            }
-            break;
+    unsigned int gameKey = GetGameKey(key);
 
-        default:
-            break;
+    // Only the first press counts, key repeat must not toggle pause back and forth
+    if (state && !(this->pressedKeys & gameKey)) {
+        this->simulation.pressKeys(gameKey);
     }
+
+    this->pressedKeys = state ? (this->pressedKeys | gameKey) : (this->pressedKeys & ~gameKey);
 }
 
 void Rubik::onSetup() {
+    if (this->shaderCache != nullptr) {
+        std::ostringstream renderer;
+        renderer << glGetString(GL_VENDOR) << " " << glGetString(GL_RENDERER) << " " << glGetString(GL_VERSION);
+        this->shaderCache->setRenderer(renderer.str());
+    }
+
     Graphene::RenderStateCallback callback([](Graphene::RenderState* renderState, const std::shared_ptr<Graphene::Object>& object) {
         renderState->getShader()->setUniform("objectId", object->getId());
     });
@@ -140,24 +240,30 @@ void Rubik::onSetup() {
 }
 
 void Rubik::onIdle() {
+    // Allocations since the last call belong to the frame before, rendering included
+    if (this->debug) {
+        uint64_t allocations = AllocationCounter::getAllocations();
+        if (allocations != this->frameAllocations && this->frames > 0) {
+            std::cerr << "Frame " << this->frames << ": " << allocations - this->frameAllocations << " allocations\n";
+        }
+        this->frameAllocations = AllocationCounter::getAllocations();
+    }
+
+    this->frames++;
+    this->frameArena.reset();
+
     this->updateScene();
     this->updateUI();
-
-    const Graphene::KeyboardState& keyboardState = this->getWindow()->getKeyboardState();
-    if (this->state == GameState::RUNNING && !keyboardState[Graphene::KeyboardKey::KEY_S]) {
-        this->gameTime += this->getFrameTime();
-    }
 }
 
 void Rubik::setupScene() {
     /* Setup scene */
 
     auto& scene = this->createScene();
-    scene->setAmbientEnergy(0.2f);
+    scene->setAmbientEnergy(AMBIENT_ENERGY);
 
     auto& sceneRoot = scene->getRoot();
     auto& player = scene->getPlayer();
-    this->puzzle = std::make_shared<Puzzle>();
 
     auto cube = std::make_shared<Graphene::ObjectGroup>();
     sceneRoot->addObject(cube);
@@ -165,8 +271,6 @@ void Rubik::setupScene() {
     /* Populate scene with objects */
 
     auto& objectManager = Graphene::GetObjectManager();
-    auto& renderManager = Graphene::GetRenderManager();
-    renderManager.setLightPass(true);
 
     auto background = objectManager.createEntity("assets/background.entity");
     background->translate(0.0f, 0.0f, 5.0f);
@@ -178,7 +282,10 @@ void Rubik::setupScene() {
 
     player->addObject(camera);
     player->addObject(light);
-    player->translate(0.25f, -0.25f, -4.5f);
+    player->translate(PLAYER_POSITION.get(Math::Vec3::X), PLAYER_POSITION.get(Math::Vec3::Y), PLAYER_POSITION.get(Math::Vec3::Z));
+    this->lights.push_back(light);
+    this->setupShading(scene);
+    this->setupPostProcessing();
 
     for (int i = -1; i <= 1; i++) {
         for (int j = -1; j <= 1; j++) {
@@ -186,19 +293,41 @@ void Rubik::setupScene() {
                 auto cubepart = std::make_shared<Graphene::ObjectGroup>();
                 cube->addObject(cubepart);
 
-                auto entity = objectManager.createEntity("assets/cubepart.entity");
-                entity->translate(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k));
-                cubepart->addObject(entity);
+                // Each cube only draws the sides facing out of the puzzle, the sides facing
+                // other cubes are drawn while a turn exposes them. The core is never seen.
+                int objectId = cubepart->getId();
+                std::shared_ptr<Graphene::Entity> innerEntity;
+
+                if (i != 0 || j != 0 || k != 0) {
+                    std::stringstream mesh;
+                    mesh << "assets/cubepart-" << i + 1 << j + 1 << k + 1;
 
-                this->puzzle->addCube(entity);
-                this->puzzleObjects.push_back(entity->getId());
+                    auto entity = objectManager.createEntity(mesh.str() + ".entity");
+                    entity->translate(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k));
+                    cubepart->addObject(entity);
+                    objectId = entity->getId();
+
+                    innerEntity = objectManager.createEntity(mesh.str() + "-inner.entity");
+                    innerEntity->translate(static_cast<float>(i), static_cast<float>(j), static_cast<float>(k));
+                    innerEntity->setVisible(false);
+                    cubepart->addObject(innerEntity);
+                }
+
+                this->simulation.getPuzzle().addCube(objectId);
+                this->puzzleObjects.push_back(objectId);
+                this->cubeGroups.push_back(cubepart);
+                this->cubeRotations.emplace_back();
+                this->innerEntities.push_back(innerEntity);
             }
         }
     }
 
     cube->roll(-30.0f);
     cube->yaw(-30.0f);
-    this->puzzle->shuffle(this->shuffles);
+    if (!this->simulation.restoreSession()) {
+        this->simulation.shufflePuzzle();
+    }
+    this->simulation.start();
 
     /* Update default viewport with camera */
 
@@ -213,6 +342,49 @@ void Rubik::setupScene() {
     pickupViewport->setCamera(camera);
 }
 
+void Rubik::setupShading(const std::shared_ptr<Graphene::Scene>& scene) {
+    auto& renderManager = Graphene::GetRenderManager();
+    bool forwardShading = (this->renderMode == RenderMode::FORWARD) ||
+            (this->renderMode == RenderMode::AUTO && static_cast<int>(this->lights.size()) <= FORWARD_LIGHTS);
+
+    renderManager.setLightPass(!forwardShading);
+    if (!forwardShading) {
+        return;
+    }
+
+    // Shade in the geometry pass and skip the G-buffer lighting passes altogether. Parameters are
+    // read from the scene every draw, so both paths light the same way whatever the scene sets.
+    std::shared_ptr<Graphene::Light> light = this->lights.empty() ? nullptr : this->lights.front();
+    Graphene::RenderStateCallback callback([scene, light](Graphene::RenderState* renderState, const std::shared_ptr<Graphene::Object>& /*object*/) {
+        auto& shader = renderState->getShader();
+        shader->setUniform("cameraPosition", PLAYER_POSITION);
+        shader->setUniform("ambientColor", scene->getAmbientColor());
+        shader->setUniform("ambientEnergy", scene->getAmbientEnergy());
+
+        if (light != nullptr) {
+            shader->setUniform("lightDirection", light->getDirection());
+            shader->setUniform("lightColor", light->getColor());
+            shader->setUniform("lightEnergy", light->getEnergy());
+        } else {
+            shader->setUniform("lightEnergy", 0.0f);  // Ambient only
+        }
+    });
+
+    auto& renderState = renderManager.getRenderState(Graphene::RenderBuffer::COLOR);
+    renderState->setShader(Graphene::GetObjectManager().createShader("shaders/forward_output.shader"));
+    renderState->setCallback(callback);
+}
+
+void Rubik::setupPostProcessing() {
+    if (!this->fxaa) {
+        return;
+    }
+
+    // One full-screen pass over the lit image instead of multisampling every G-buffer target
+    auto& renderState = Graphene::GetRenderManager().getRenderState(Graphene::RenderBuffer::OUTPUT);
+    renderState->setShader(Graphene::GetObjectManager().createShader("shaders/fxaa_output.shader"));
+}
+
 void Rubik::setupUI() {
     /* Setup scene */
 
@@ -222,27 +394,43 @@ void Rubik::setupUI() {
     /* Populate scene with objects */
 
     auto& objectManager = Graphene::GetObjectManager();
+    auto& window = this->getWindow();
     auto camera = objectManager.createCamera(Graphene::ProjectionType::ORTHOGRAPHIC);
     camera->setNearPlane(-1.0f);  // NDC for 1:1 scale
     camera->setFarPlane(1.0f);  // NDC for 1:1 scale
 
-    this->timeLabel = objectManager.createLabel(150, 20, "fonts/dejavu-sans.ttf", 12);
-    this->movesLabel = objectManager.createLabel(150, 20, "fonts/dejavu-sans.ttf", 12);
-    this->promptLabel = objectManager.createLabel(150, 20, "fonts/dejavu-sans.ttf", 12);
+    this->timeLabel = this->createLabel(150, 20);
+    this->movesLabel = this->createLabel(150, 20);
+    this->promptLabel = this->createLabel(150, 20);
+    this->caseLabel = this->createLabel(window->getWidth() - 20, 20);
+    this->algorithmLabel = this->createLabel(window->getWidth() - 20, 20);
+    this->recognizedFrame = -1;
+
+    this->statsLabels.clear();
+    for (int line = 0; line < 3; line++) {
+        this->statsLabels.push_back(this->createLabel(200, 20));
+        uiRoot->addObject(this->statsLabels.back().entity);
+    }
+    this->statsSolves = UINT64_MAX;
 
     uiRoot->addObject(camera);
-    uiRoot->addObject(this->timeLabel);
-    uiRoot->addObject(this->movesLabel);
-    uiRoot->addObject(this->promptLabel);
+    uiRoot->addObject(this->timeLabel.entity);
+    uiRoot->addObject(this->movesLabel.entity);
+    uiRoot->addObject(this->promptLabel.entity);
+    uiRoot->addObject(this->caseLabel.entity);
+    uiRoot->addObject(this->algorithmLabel.entity);
 
     /* Arrange UI elements */
 
-    auto& window = this->getWindow();
-
     auto uiLayout = std::make_shared<Graphene::Layout>();
-    uiLayout->addEntity(this->timeLabel, (window->getWidth() - 120) / 2, window->getHeight() - 25);
-    uiLayout->addEntity(this->movesLabel, (window->getWidth() - 70) / 2, window->getHeight() - 50);
-    uiLayout->addEntity(this->promptLabel, (window->getWidth() - 110) / 2, 10);
+    uiLayout->addEntity(this->timeLabel.entity, (window->getWidth() - 120) / 2, window->getHeight() - 25);
+    uiLayout->addEntity(this->movesLabel.entity, (window->getWidth() - 70) / 2, window->getHeight() - 50);
+    uiLayout->addEntity(this->promptLabel.entity, (window->getWidth() - 110) / 2, 10);
+    uiLayout->addEntity(this->caseLabel.entity, 10, 60);
+    uiLayout->addEntity(this->algorithmLabel.entity, 10, 35);
+    for (size_t line = 0; line < this->statsLabels.size(); line++) {
+        uiLayout->addEntity(this->statsLabels[line].entity, 10, window->getHeight() - 25 * static_cast<int>(line + 1));
+    }
 
     /* Update viewport with camera */
 
@@ -253,108 +441,146 @@ void Rubik::setupUI() {
 
 void Rubik::updateScene() {
     const Graphene::KeyboardState& keyboardState = this->getWindow()->getKeyboardState();
+    static const Graphene::KeyboardKey keys[] = {
+        Graphene::KeyboardKey::KEY_S, Graphene::KeyboardKey::KEY_ESCAPE,
+        Graphene::KeyboardKey::KEY_Y, Graphene::KeyboardKey::KEY_N
+    };
+
+    unsigned int heldKeys = 0;
+    for (auto key: keys) {
+        if (keyboardState[key]) {
+            heldKeys |= GetGameKey(key);
+        }
+    }
+    this->simulation.setKeys(heldKeys);
 
-    switch (this->state) {
-        case GameState::RUNNING:
-            if (this->puzzle->isSolved()) {
-                this->state = GameState::FINISHED;
-            } else if (keyboardState[Graphene::KeyboardKey::KEY_ESCAPE]) {
-                this->state = GameState::QUIT;
-            } else if (keyboardState[Graphene::KeyboardKey::KEY_S]) {
-                this->puzzle->selectCube(this->puzzleObjects[std::rand() % this->puzzleObjects.size()]);
-                this->puzzle->setAnimationState(static_cast<AnimationState>(std::rand() % 4 + 1));
-            }
+    if (!this->simulation.updateSnapshot()) {
+        return;
+    }
 
-            this->puzzle->update(this->getFrameTime());
-            break;
+    const GameSnapshot& snapshot = this->simulation.getSnapshot();
+    if (snapshot.state == GameState::EXIT) {
+        this->exit(0);
+        return;
+    }
 
-        case GameState::QUIT:
-            if (keyboardState[Graphene::KeyboardKey::KEY_Y]) {
-                this->exit(0);
-            } else if (keyboardState[Graphene::KeyboardKey::KEY_N]) {
-                this->state = GameState::RUNNING;
-            }
-            break;
+    // Groups only take relative rotations, apply whatever happened since the last snapshot
+    for (size_t cube = 0; cube < this->cubeGroups.size(); cube++) {
+        const Quaternion& rotation = snapshot.rotations[cube];
+        Quaternion delta(rotation * this->cubeRotations[cube].conjugate());
 
-        case GameState::FINISHED:
-            if (keyboardState[Graphene::KeyboardKey::KEY_N]) {
-                this->exit(0);
-            } else if (keyboardState[Graphene::KeyboardKey::KEY_Y]) {
-                this->moves = 0;
-                this->gameTime = 0.0f;
-                this->state = GameState::RUNNING;
-                this->puzzle->shuffle(this->shuffles);
-            }
-            break;
+        float angle = delta.getAngle();
+        if (angle > 0.0f) {
+            float x, y, z;
+            delta.getAxis(x, y, z);
+            this->cubeGroups[cube]->rotate(Math::Vec3(x, y, z), angle);
+        }
 
-        default:
-            break;
+        this->cubeRotations[cube] = rotation;
+    }
+
+    // One lookup per change of the cube as seen, turns in progress are not counted until done
+    if (this->training && (snapshot.cubeState != this->recognizedState || snapshot.frame != this->recognizedFrame)) {
+        const Recognizer::Case& cubeCase = this->recognizer.recognize(Symmetry::conjugate(snapshot.frame, snapshot.cubeState));
+        this->setLabelText(this->caseLabel, this->formatText(L"%s", cubeCase.name.c_str()));
+        this->setLabelText(this->algorithmLabel, this->formatText(L"%s", cubeCase.algorithm.c_str()));
+
+        this->recognizedState = snapshot.cubeState;
+        this->recognizedFrame = snapshot.frame;
+    }
+
+    // Inner sides show on the turning layer and the layers next to it
+    for (size_t cube = 0; cube < this->innerEntities.size(); cube++) {
+        if (this->innerEntities[cube] != nullptr) {
+            int position[] = { snapshot.positions[cube] / 9, snapshot.positions[cube] / 3 % 3 };
+            bool isExposed = (snapshot.turnAxis != -1 && std::abs(position[snapshot.turnAxis] - snapshot.turnLayer) <= 1);
+            this->innerEntities[cube]->setVisible(isExposed);
+        }
     }
 }
 
 void Rubik::updateUI() {
-    int gameTime = static_cast<int>(this->gameTime);
+    const GameSnapshot& snapshot = this->simulation.getSnapshot();
+
+    int gameTime = static_cast<int>(snapshot.gameTime);
     int seconds = gameTime % 60;
     int minutes = gameTime / 60;
     int hours = gameTime / 3600;
 
-    std::wstringstream time;
-    time << "Time: " << std::setw(2) << std::setfill(L'0') << hours << ":"
-                     << std::setw(2) << std::setfill(L'0') << minutes << ":"
-                     << std::setw(2) << std::setfill(L'0') << seconds;
-    this->timeLabel->getComponent<Graphene::TextComponent>()->setText(time.str());
+    this->setLabelText(this->timeLabel, this->formatText(L"Time: %02d:%02d:%02d", hours, minutes, seconds));
+    this->setLabelText(this->movesLabel, this->formatText(L"Moves: %d", snapshot.moves));
+
+    // Statistics only change with a solve
+    const SolveStats& stats = snapshot.stats;
+    if (stats.count != this->statsSolves) {
+        const float values[] = { stats.best, stats.mean, stats.average5, stats.average12, stats.average100 };
+        wchar_t* times[5];
+        for (int value = 0; value < 5; value++) {
+            times[value] = this->frameArena.allocate<wchar_t>(SOLVE_TIME_LENGTH);
+            FormatSolveTime(values[value], times[value], SOLVE_TIME_LENGTH);
+        }
+
+        this->setLabelText(this->statsLabels[0], this->formatText(L"Best: %ls  Mean: %ls", times[0], times[1]));
+        this->setLabelText(this->statsLabels[1], this->formatText(L"Ao5: %ls  Ao12: %ls", times[2], times[3]));
+        this->setLabelText(this->statsLabels[2], this->formatText(L"Ao100: %ls  Solves: %llu", times[4],
+                static_cast<unsigned long long>(stats.count)));
 
-    std::wstringstream moves;
-    moves << "Moves: " << this->moves;
-    this->movesLabel->getComponent<Graphene::TextComponent>()->setText(moves.str());
+        this->statsSolves = stats.count;
+    }
+
+    bool isCaseVisible = (this->training && snapshot.state == GameState::RUNNING);
+    this->caseLabel.entity->setVisible(isCaseVisible);
+    this->algorithmLabel.entity->setVisible(isCaseVisible);
 
-    switch (this->state) {
+    switch (snapshot.state) {
         case GameState::FINISHED:
-            this->promptLabel->getComponent<Graphene::TextComponent>()->setText(L"New game? Y/N");
-            this->promptLabel->setVisible(true);
+            this->setLabelText(this->promptLabel, L"New game? Y/N");
+            this->promptLabel.entity->setVisible(true);
             break;
 
         case GameState::PAUSED:
-            this->promptLabel->getComponent<Graphene::TextComponent>()->setText(L"       Paused");
-            this->promptLabel->setVisible(true);
+            this->setLabelText(this->promptLabel, L"       Paused");
+            this->promptLabel.entity->setVisible(true);
             break;
 
         case GameState::QUIT:
-            this->promptLabel->getComponent<Graphene::TextComponent>()->setText(L"    Quit? Y/N");
-            this->promptLabel->setVisible(true);
+            this->setLabelText(this->promptLabel, L"    Quit? Y/N");
+            this->promptLabel.entity->setVisible(true);
             break;
 
         default:
-            this->promptLabel->setVisible(false);
+            this->promptLabel.entity->setVisible(false);
             break;
     }
 }
 
-void Rubik::rotateCube(int objectId, const Math::Vec3& direction) {
-    if (this->state == GameState::PAUSED) {
-        return;  // No action on pause
-    }
-
-    if (direction.length() < 1.5f) {
-        return;  // Movement is too short
-    }
+Rubik::Label Rubik::createLabel(int width, int height) {
+    Label label;
+    label.entity = Graphene::GetObjectManager().createLabel(width, height, "fonts/dejavu-sans.ttf", 12);
+    label.component = label.entity->getComponent<Graphene::TextComponent>();
+    label.text.reserve(LABEL_LENGTH);
+    return label;
+}
 
-    if (objectId != -1 && this->puzzle->getAnimationState() == AnimationState::IDLE) {
-        this->moves++;
+void Rubik::setLabelText(Label& label, std::wstring_view text) {
+    if (label.text != text) {
+        label.text.assign(text.data(), std::min(text.size(), LABEL_LENGTH));
+        label.component->setText(label.text);
     }
+}
 
-    float xDirection = direction.get(Math::Vec3::X);
-    float yDirection = direction.get(Math::Vec3::Y);
-    AnimationState puzzleState = AnimationState::IDLE;
+// Text in the frame arena, valid until the next frame
+std::wstring_view Rubik::formatText(const wchar_t* format, ...) {
+    wchar_t* text = this->frameArena.allocate<wchar_t>(LABEL_LENGTH);
+    text[0] = L'\0';
 
-    if (fabsf(xDirection) > fabsf(yDirection)) {
-        puzzleState = (xDirection > 0) ? AnimationState::RIGHT_ROTATION : AnimationState::LEFT_ROTATION;
-    } else {
-        puzzleState = (yDirection > 0) ? AnimationState::DOWN_ROTATION : AnimationState::UP_ROTATION;
-    }
+    va_list arguments;
+    va_start(arguments, format);
+    int length = std::vswprintf(text, LABEL_LENGTH, format, arguments);
+    va_end(arguments);
 
-    this->puzzle->selectCube(objectId);
-    this->puzzle->setAnimationState(puzzleState);
+    // Too long to fit, keep what did
+    return std::wstring_view(text, (length >= 0) ? static_cast<size_t>(length) : std::wcslen(text));
 }
 
 }  // namespace Rubik
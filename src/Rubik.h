@@ -23,17 +23,29 @@
 #ifndef RUBIK_H
 #define RUBIK_H
 
-#include <Puzzle.h>
+#include <Simulation.h>
+#include <Recognizer.h>
+#include <FrameArena.h>
+#include <Quaternion.h>
+#include <ShaderCache.h>
 #include <Engine.h>
 #include <Input.h>
 #include <FrameBuffer.h>
 #include <Entity.h>
-#include <Vec3.h>
+#include <ObjectGroup.h>
+#include <Light.h>
+#include <Scene.h>
+#include <TextComponent.h>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 namespace Rubik {
 
+enum class RenderMode { AUTO, FORWARD, DEFERRED };
+
 class Rubik: public Graphene::Engine {
 public:
     Rubik();
@@ -41,33 +53,90 @@ public:
     int getShuffles() const;
     void setShuffles(int shuffles);
 
+    bool isRandomState() const;
+    void setRandomState(bool randomState);
+
+    uint64_t getSeed() const;
+    void setSeed(uint64_t seed);
+
+    SolveLog& getSolveLog();
+
+    const std::string& getSessionPath() const;
+    void setSessionPath(const std::string& sessionPath);
+
+    RenderMode getRenderMode() const;
+    void setRenderMode(RenderMode renderMode);
+
+    bool isTraining() const;
+    void setTraining(bool training);
+
+    bool isFxaa() const;
+    void setFxaa(bool fxaa);
+
+    // Report heap allocations of every frame that made any
+    bool isDebug() const;
+    void setDebug(bool debug);
+
+    const std::shared_ptr<ShaderCache>& getShaderCache() const;
+    void setShaderCache(const std::shared_ptr<ShaderCache>& shaderCache);
+
 private:
+    // Text is handed to the engine only when it changes, the last one kept in reserved storage
+    struct Label {
+        std::shared_ptr<Graphene::Entity> entity;
+        std::shared_ptr<Graphene::TextComponent> component;
+        std::wstring text;
+    };
+
     void onMouseMotion(int x, int y) override;
     void onKeyboardKey(Graphene::KeyboardKey key, bool state) override;
     void onSetup() override;
     void onIdle() override;
 
     void setupScene();
+    void setupShading(const std::shared_ptr<Graphene::Scene>& scene);
+    void setupPostProcessing();
     void setupUI();
     void updateScene();
     void updateUI();
 
-    void rotateCube(int objectId, const Math::Vec3& direction);
+    Label createLabel(int width, int height);
+    void setLabelText(Label& label, std::wstring_view text);
+    std::wstring_view formatText(const wchar_t* format, ...);
+
+    Simulation simulation;
+    std::vector<std::shared_ptr<Graphene::ObjectGroup>> cubeGroups;  // In Puzzle cube order
+    std::vector<Quaternion> cubeRotations;  // Last rotation applied to each group
+    std::vector<std::shared_ptr<Graphene::Entity>> innerEntities;  // Sides facing other cubes, none for the core
+    std::vector<std::shared_ptr<Graphene::Light>> lights;  // Every light added to the scene
+
+    Label timeLabel;
+    Label movesLabel;
+    Label promptLabel;
+    std::vector<Label> statsLabels;
+    uint64_t statsSolves = 0;  // Solve count the statistics labels show
 
-    std::shared_ptr<Puzzle> puzzle;
-    std::shared_ptr<Graphene::Entity> timeLabel;
-    std::shared_ptr<Graphene::Entity> movesLabel;
-    std::shared_ptr<Graphene::Entity> promptLabel;
+    // Training mode names the CFOP case of the cube as seen and the algorithm for it
+    Recognizer recognizer;
+    Label caseLabel;
+    Label algorithmLabel;
+    CubeState recognizedState;
+    int recognizedFrame = -1;
+    bool training = false;
 
     std::vector<int> puzzleObjects;
     std::shared_ptr<Graphene::FrameBuffer> pickupBuffer;
+    std::shared_ptr<ShaderCache> shaderCache;
 
-    int shuffles = 20;
-    int moves = 0;
-    float gameTime = 0.0f;
+    // UI text is formatted in a per-frame arena rather than on the heap
+    FrameArena frameArena;
+    uint64_t frames = 0;
+    uint64_t frameAllocations = 0;
+    bool debug = false;
 
-    enum class GameState { RUNNING, PAUSED, QUIT, FINISHED };
-    GameState state = GameState::RUNNING;
+    RenderMode renderMode = RenderMode::AUTO;
+    bool fxaa = false;
+    unsigned int pressedKeys = 0;
 };
 
 }  // namespace Rubik
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Scrambler.h>
+#include <Random.h>
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+
+namespace Rubik {
+
+Scrambler::Scrambler(uint64_t seed):
+        seed(seed) {
+}
+
+uint64_t Scrambler::getSeed() const {
+    return this->seed;
+}
+
+CubeState Scrambler::getState(uint64_t index) const {
+    Random random(this->seed, index);
+
+    while (true) {
+        CubeState state(CubeState::random(random));
+        bool isTrivial = state.isSolved();
+
+        // Competition scrambles must not be solvable in less than two moves
+        for (int move = 0; move < CubeState::MOVES && !isTrivial; move++) {
+            CubeState moved(state);
+            moved.applyMove(static_cast<Move>(move));
+            isTrivial = moved.isSolved();
+        }
+
+        if (!isTrivial) {
+            return state;
+        }
+    }
+}
+
+std::vector<Move> Scrambler::getScramble(uint64_t index) const {
+    std::vector<Move> solution;
+    if (!this->solver.solve(this->getState(index), Scrambler::MAX_LENGTH, solution)) {
+        throw std::runtime_error("getScramble(): no solution found");
+    }
+
+    std::vector<Move> scramble;
+    for (auto move = solution.rbegin(); move != solution.rend(); move++) {
+        scramble.push_back(InverseMove(*move));
+    }
+
+    return scramble;
+}
+
+void Scrambler::generate(uint64_t first, std::vector<std::vector<Move>>& scrambles) const {
+    std::atomic<size_t> nextScramble(0);
+    auto worker = [this, first, &scrambles, &nextScramble]() {
+        for (size_t i = nextScramble++; i < scrambles.size(); i = nextScramble++) {
+            scrambles[i] = this->getScramble(first + i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < std::max(std::thread::hardware_concurrency(), 1u); i++) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+}
+
+void Scrambler::write(std::ostream& output, uint64_t first, uint64_t count) const {
+    const uint64_t batchSize = 65536;
+    std::vector<std::vector<Move>> scrambles;
+
+    for (uint64_t batch = 0; batch < count; batch += batchSize) {
+        scrambles.resize(std::min(batchSize, count - batch));
+        this->generate(first + batch, scrambles);
+
+        for (auto& scramble: scrambles) {
+            for (size_t i = 0; i < scramble.size(); i++) {
+                output << ((i > 0) ? " " : "") << MoveName(scramble[i]);
+            }
+
+            output << "\n";
+        }
+    }
+}
+
+}  // namespace Rubik
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SCRAMBLER_H
+#define SCRAMBLER_H
+
+#include <CubeState.h>
+#include <Solver.h>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+namespace Rubik {
+
+// Random-state scrambler: scramble #index draws a uniformly random reachable state from its own
+// Random(seed, index) stream and returns the inverse of a two-phase solution for it. Scrambles
+// do not depend on the order or the number of threads they are generated with.
+class Scrambler {
+public:
+    static const int MAX_LENGTH = 22;
+
+    Scrambler(uint64_t seed);
+
+    uint64_t getSeed() const;
+
+    CubeState getState(uint64_t index) const;
+    std::vector<Move> getScramble(uint64_t index) const;
+
+    void generate(uint64_t first, std::vector<std::vector<Move>>& scrambles) const;
+    void write(std::ostream& output, uint64_t first, uint64_t count) const;
+
+private:
+    uint64_t seed;
+    Solver solver;
+};
+
+}  // namespace Rubik
+
+#endif  // SCRAMBLER_H
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Server.h>
+#include <Symmetry.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+#include <csignal>
+#include <cerrno>
+#include <thread>
+
+namespace Rubik {
+
+static const size_t BATCH_SIZE = 64;
+static const int SOLVE_LENGTH = 22;
+
+static bool SendAll(int socket, const std::string& data) {
+    for (size_t sent = 0; sent < data.size();) {
+        ssize_t written = ::send(socket, data.data() + sent, data.size() - sent, 0);
+        if (written == -1 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        sent += written;
+    }
+
+    return true;
+}
+
+Server::Server(const std::string& path):
+        path(path),
+        socket(-1),
+        running(false),
+        requests(0),
+        cacheHits(0),
+        totalLatency(0),
+        maxLatency(0),
+        maxQueueDepth(0) {
+    this->threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+Server::~Server() {
+    this->stop();
+}
+
+int Server::getThreads() const {
+    return this->threads;
+}
+
+void Server::setThreads(int threads) {
+    if (threads < 1) {
+        throw std::invalid_argument("Server: thread count must be positive");
+    }
+
+    this->threads = threads;
+}
+
+size_t Server::getCacheSize() const {
+    return this->cacheSize;
+}
+
+void Server::setCacheSize(size_t cacheSize) {
+    this->cacheSize = cacheSize;
+}
+
+void Server::run() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (this->path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Server: socket path is too long");
+    }
+    std::strncpy(address.sun_path, this->path.c_str(), sizeof(address.sun_path) - 1);
+
+    this->socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (this->socket == -1) {
+        throw std::runtime_error("Server: failed to create socket: " + std::string(std::strerror(errno)));
+    }
+
+    ::unlink(this->path.c_str());
+    if (::bind(this->socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+            ::listen(this->socket, SOMAXCONN) == -1) {
+        int error = errno;
+        ::close(this->socket);
+        this->socket = -1;
+        throw std::runtime_error("Server: failed to listen on " + this->path + ": " + std::strerror(error));
+    }
+
+    // Clients going away mid-response must not take the daemon down
+    std::signal(SIGPIPE, SIG_IGN);
+    this->running = true;
+    this->working = true;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < this->threads; i++) {
+        workers.emplace_back(&Server::work, this);
+    }
+
+    while (this->running) {
+        int client = ::accept(this->socket, nullptr, nullptr);
+        if (client == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(this->clientsMutex);
+        this->clients.push_back(client);
+        std::thread(&Server::serveClient, this, client).detach();
+    }
+
+    this->running = false;
+    {
+        std::unique_lock<std::mutex> lock(this->clientsMutex);
+        for (int client: this->clients) {
+            ::shutdown(client, SHUT_RDWR);
+        }
+        this->clientsCondition.wait(lock, [this] { return this->clients.empty(); });
+    }
+
+    // Workers outlive the clients so that every queued request still gets its response
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->working = false;
+    }
+    this->queueCondition.notify_all();
+    for (auto& thread: workers) {
+        thread.join();
+    }
+
+    ::unlink(this->path.c_str());
+}
+
+void Server::stop() {
+    this->running = false;
+
+    // Only system calls here, this runs from SIGINT and SIGTERM handlers too
+    int socket = this->socket.exchange(-1);
+    if (socket != -1) {
+        ::shutdown(socket, SHUT_RDWR);
+        ::close(socket);
+    }
+}
+
+void Server::serveClient(int client) {
+    std::string buffer;
+    char data[4096];
+
+    while (true) {
+        ssize_t size = ::recv(client, data, sizeof(data), 0);
+        if (size == -1 && errno == EINTR) {
+            continue;
+        }
+        if (size <= 0) {
+            break;
+        }
+        buffer.append(data, size);
+
+        // Everything received so far is queued at once, so pipelined requests land in one batch
+        std::vector<std::future<std::string>> responses;
+        size_t start = 0;
+        for (size_t end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', start)) {
+            auto request = std::make_shared<Request>();
+            request->command = buffer.substr(start, end - start);
+            request->received = std::chrono::steady_clock::now();
+            responses.push_back(request->response.get_future());
+            start = end + 1;
+
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->queue.push_back(request);
+        }
+        buffer.erase(0, start);
+
+        if (responses.empty()) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->maxQueueDepth = std::max(this->maxQueueDepth.load(), this->queue.size());
+        }
+        this->queueCondition.notify_all();
+
+        std::string output;
+        for (auto& response: responses) {
+            output += response.get();
+            output += '\n';
+        }
+
+        if (!SendAll(client, output)) {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->clientsMutex);
+    this->clients.erase(std::find(this->clients.begin(), this->clients.end(), client));
+    ::close(client);
+    this->clientsCondition.notify_all();
+}
+
+void Server::work() {
+    std::vector<std::shared_ptr<Request>> batch;
+    batch.reserve(BATCH_SIZE);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->queueMutex);
+            this->queueCondition.wait(lock, [this] { return !this->queue.empty() || !this->working; });
+            if (this->queue.empty()) {
+                return;
+            }
+
+            while (!this->queue.empty() && batch.size() < BATCH_SIZE) {
+                batch.push_back(std::move(this->queue.front()));
+                this->queue.pop_front();
+            }
+        }
+
+        for (auto& request: batch) {
+            std::string response = this->process(request->command);
+
+            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - request->received).count();
+            this->totalLatency += latency;
+            uint64_t maxLatency = this->maxLatency;
+            while (static_cast<uint64_t>(latency) > maxLatency &&
+                    !this->maxLatency.compare_exchange_weak(maxLatency, latency)) {
+            }
+            this->requests++;
+
+            request->response.set_value(response);
+        }
+        batch.clear();
+    }
+}
+
+std::string Server::process(const std::string& command) {
+    std::string request = command;
+    if (!request.empty() && request.back() == '\r') {
+        request.pop_back();
+    }
+
+    size_t separator = request.find(' ');
+    std::string name = request.substr(0, separator);
+    std::string arguments = (separator != std::string::npos) ? request.substr(separator + 1) : "";
+
+    if (name == "SOLVE") {
+        return this->solve(arguments);
+    } else if (name == "STATS") {
+        return this->getStats();
+    }
+
+    return "ERROR unknown command '" + name + "'";
+}
+
+std::string Server::solve(const std::string& moves) {
+    CubeState state;
+    std::istringstream stream(moves);
+    std::string token;
+    while (stream >> token) {
+        Move move;
+        if (!ParseMove(token, move)) {
+            return "ERROR unknown move '" + token + "'";
+        }
+        state.applyMove(move);
+    }
+
+    int symmetry;
+    CubeState canonical = Symmetry::canonicalize(state, symmetry);
+    StateRank rank(canonical);
+
+    std::vector<Move> solution;
+    if (this->findCached(rank, solution)) {
+        this->cacheHits++;
+    } else {
+        if (!this->solver.solve(canonical, SOLVE_LENGTH, solution) &&
+                !this->solver.solve(canonical, Solver::MAX_LENGTH, solution)) {
+            return "ERROR no solution found";  // Not cached, a later request tries again
+        }
+        this->addCached(rank, solution);
+    }
+
+    // conjugate() is a homomorphism, so mapping the moves back solves the original state
+    int inverse = Symmetry::inverse(symmetry);
+    std::string response = "OK";
+    for (Move move: solution) {
+        response += ' ';
+        response += MoveName(Symmetry::conjugate(inverse, move));
+    }
+
+    return response;
+}
+
+std::string Server::getStats() const {
+    uint64_t requests = this->requests;
+    size_t queueDepth;
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        queueDepth = this->queue.size();
+    }
+
+    std::ostringstream stats;
+    stats << "OK requests=" << requests
+          << " cache_hits=" << this->cacheHits
+          << " queue_depth=" << queueDepth
+          << " max_queue_depth=" << this->maxQueueDepth
+          << " mean_latency_us=" << (requests > 0 ? this->totalLatency / requests : 0)
+          << " max_latency_us=" << this->maxLatency;
+    return stats.str();
+}
+
+bool Server::findCached(const StateRank& rank, std::vector<Move>& solution) {
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+
+    auto cached = this->cache.find(rank);
+    if (cached != this->cache.end()) {
+        solution = cached->second;
+        return true;
+    }
+
+    cached = this->previousCache.find(rank);
+    if (cached != this->previousCache.end()) {
+        solution = cached->second;
+        this->cache.emplace(rank, std::move(cached->second));
+        this->previousCache.erase(cached);
+        return true;
+    }
+
+    return false;
+}
+
+void Server::addCached(const StateRank& rank, const std::vector<Move>& solution) {
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+
+    if (this->cache.size() >= this->cacheSize / 2) {
+        this->previousCache = std::move(this->cache);
+        this->cache.clear();
+    }
+
+    this->cache.emplace(rank, solution);
+}
+
+}  // namespace Rubik
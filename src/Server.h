@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <CubeState.h>
+#include <StateRank.h>
+#include <Solver.h>
+#include <unordered_map>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace Rubik {
+
+// Solver daemon on a Unix domain socket. Requests are newline terminated and may be pipelined,
+// responses come back in the same order:
+//
+//     SOLVE R U R' U'     ->  OK U R U' R'
+//     STATS               ->  OK requests=... cache_hits=... queue_depth=... ...
+//
+// Requests from all clients go through one queue which workers drain in batches. Solutions are
+// cached by the canonical state of their symmetry class.
+class Server {
+public:
+    Server(const std::string& path);
+    ~Server();
+
+    int getThreads() const;
+    void setThreads(int threads);
+
+    size_t getCacheSize() const;
+    void setCacheSize(size_t cacheSize);
+
+    void run();
+    void stop();
+
+private:
+    struct Request {
+        std::string command;
+        std::promise<std::string> response;
+        std::chrono::steady_clock::time_point received;
+    };
+
+    void serveClient(int client);
+    void work();
+
+    std::string process(const std::string& command);
+    std::string solve(const std::string& moves);
+    std::string getStats() const;
+
+    bool findCached(const StateRank& rank, std::vector<Move>& solution);
+    void addCached(const StateRank& rank, const std::vector<Move>& solution);
+
+    std::string path;
+    std::atomic<int> socket;  // stop() may be called from a signal handler
+    int threads;
+    size_t cacheSize = 1 << 20;
+    std::atomic<bool> running;
+
+    Solver solver;
+
+    std::deque<std::shared_ptr<Request>> queue;
+    mutable std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool working = false;
+
+    // Two generations approximate LRU: hits are promoted, the older one is dropped when full
+    std::unordered_map<StateRank, std::vector<Move>> cache;
+    std::unordered_map<StateRank, std::vector<Move>> previousCache;
+    std::mutex cacheMutex;
+
+    // Client threads are detached, run() waits for the list to empty before it returns
+    std::vector<int> clients;
+    std::mutex clientsMutex;
+    std::condition_variable clientsCondition;
+
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> cacheHits;
+    std::atomic<uint64_t> totalLatency;
+    std::atomic<uint64_t> maxLatency;
+    std::atomic<size_t> maxQueueDepth;
+};
+
+}  // namespace Rubik
+
+#endif  // SERVER_H
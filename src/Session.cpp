@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Session.h>
+#include <SolveLog.h>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Rubik {
+
+static const uint32_t SESSION_MAGIC = 0x53534752;  // "RGSS"
+static const uint32_t SESSION_VERSION = 1;
+
+std::string Session::getDefaultPath() {
+    std::string solveLog(SolveLog::getDefaultPath());
+    if (solveLog.empty()) {
+        return "";
+    }
+
+    return std::filesystem::path(solveLog).replace_filename("session").string();
+}
+
+#ifdef _WIN32
+
+bool Session::read(const std::string& /* filename */, SessionRecord& /* record */) {
+    return false;
+}
+
+bool Session::write(const std::string& /* filename */, const SessionRecord& /* record */) {
+    return false;
+}
+
+void Session::remove(const std::string& /* filename */) {
+}
+
+#else
+
+bool Session::read(const std::string& filename, SessionRecord& record) {
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if (file == -1) {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) == -1 || static_cast<size_t>(status.st_size) != sizeof(File)) {
+        ::close(file);
+        return false;
+    }
+
+    void* memory = mmap(nullptr, sizeof(File), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    const File* session = static_cast<const File*>(memory);
+    bool valid = (session->magic == SESSION_MAGIC && session->version == SESSION_VERSION);
+    if (valid) {
+        record = session->record;
+    }
+
+    munmap(memory, sizeof(File));
+    return valid;
+}
+
+bool Session::write(const std::string& filename, const SessionRecord& record) {
+    std::filesystem::path path(filename);
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    std::string temporary(filename + ".tmp");
+    int file = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file == -1) {
+        return false;
+    }
+
+    File session;
+    std::memset(&session, 0, sizeof(File));  // No stray padding bytes on disk
+    session.magic = SESSION_MAGIC;
+    session.version = SESSION_VERSION;
+    session.record = record;
+
+    // The data has to be on disk before the rename makes it the session
+    bool written = (::write(file, &session, sizeof(File)) == static_cast<ssize_t>(sizeof(File)) && fsync(file) == 0);
+    ::close(file);
+
+    if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void Session::remove(const std::string& filename) {
+    ::unlink(filename.c_str());
+}
+
+#endif
+
+}  // namespace Rubik
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <Puzzle.h>
+#include <string>
+#include <cstdint>
+
+namespace Rubik {
+
+struct SessionRecord {
+    uint64_t seed;
+    uint64_t games;  // Random-state scrambles dealt so far
+    int32_t moves;
+    float gameTime;
+    Puzzle::Record puzzle;
+};
+
+// Game in progress kept in a single fixed size file. It is replaced as a whole through a temporary
+// file and a rename, so a crash leaves either the old or the new game, and is mapped back at startup
+// without any parsing. Where mapping is unsupported there are no sessions.
+class Session {
+public:
+    static std::string getDefaultPath();  // Next to the solve log
+
+    static bool read(const std::string& filename, SessionRecord& record);
+    static bool write(const std::string& filename, const SessionRecord& record);
+    static void remove(const std::string& filename);
+
+private:
+    struct File {
+        uint32_t magic;
+        uint32_t version;
+        SessionRecord record;
+    };
+};
+
+}  // namespace Rubik
+
+#endif  // SESSION_H
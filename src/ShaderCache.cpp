@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ShaderCache.h>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <cctype>
+
+namespace Rubik {
+
+static const char* const RENDERER_FILE = "renderer";
+static const char* const CACHE_SUBDIRECTORY = "rubik-shaders";  // The only place entries are removed from
+static const size_t HASH_LENGTH = 16;
+
+static uint64_t Fnv1a(uint64_t hash, const std::string& data) {
+    for (unsigned char byte: data) {
+        hash = (hash ^ byte) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+static bool IsHashName(const std::string& name) {
+    return name.length() == HASH_LENGTH && std::all_of(name.begin(), name.end(), [](char c) { return std::isxdigit(static_cast<unsigned char>(c)); });
+}
+
+static void SetEnvironment(const char* name, const std::string& value) {
+#ifdef _WIN32
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 0);  // Explicit user settings win
+#endif
+}
+
+ShaderCache::ShaderCache(const std::string& shaderDirectory, const std::string& cacheDirectory):
+        sourceHash(0xcbf29ce484222325ULL) {
+    std::vector<std::filesystem::path> shaders;
+    std::error_code error;
+    for (auto& entry: std::filesystem::directory_iterator(shaderDirectory, error)) {
+        if (entry.path().extension() == ".shader") {
+            shaders.push_back(entry.path());
+        }
+    }
+    std::sort(shaders.begin(), shaders.end());
+
+    for (auto& shader: shaders) {
+        std::ifstream file(shader, std::ios::binary);
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        this->sourceHash = Fnv1a(this->sourceHash, shader.filename().string());
+        this->sourceHash = Fnv1a(this->sourceHash, source);
+    }
+
+    std::ostringstream hash;
+    hash << std::hex << std::setw(HASH_LENGTH) << std::setfill('0') << this->sourceHash;
+    this->directory = (std::filesystem::path(cacheDirectory) / CACHE_SUBDIRECTORY / hash.str()).string();
+}
+
+const std::string& ShaderCache::getDirectory() const {
+    return this->directory;
+}
+
+uint64_t ShaderCache::getSourceHash() const {
+    return this->sourceHash;
+}
+
+std::string ShaderCache::getDefaultDirectory() {
+    const char* cache = std::getenv("XDG_CACHE_HOME");
+    if (cache != nullptr && *cache != '\0') {
+        return (std::filesystem::path(cache) / "rubik").string();
+    }
+
+#ifdef _WIN32
+    cache = std::getenv("LOCALAPPDATA");
+    if (cache != nullptr && *cache != '\0') {
+        return (std::filesystem::path(cache) / "rubik").string();
+    }
+#else
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && *home != '\0') {
+        return (std::filesystem::path(home) / ".cache" / "rubik").string();
+    }
+#endif
+
+    return "";
+}
+
+// Has to run before the engine creates its GL context
+bool ShaderCache::enable() {
+    std::filesystem::path directory(this->directory);
+    std::error_code error;
+
+    // Older source versions only, whatever else shares the directory isn't ours to touch
+    for (auto& entry: std::filesystem::directory_iterator(directory.parent_path(), error)) {
+        if (entry.path() != directory && entry.is_directory(error) && IsHashName(entry.path().filename().string())) {
+            std::filesystem::remove_all(entry.path(), error);
+        }
+    }
+
+    if (!std::filesystem::create_directories(directory, error) && error) {
+        return false;
+    }
+
+    SetEnvironment("MESA_SHADER_CACHE_DIR", this->directory);
+    SetEnvironment("MESA_SHADER_CACHE_DISABLE", "false");
+    SetEnvironment("__GL_SHADER_DISK_CACHE", "1");
+    SetEnvironment("__GL_SHADER_DISK_CACHE_PATH", this->directory);
+    return true;
+}
+
+void ShaderCache::setRenderer(const std::string& renderer) {
+    std::filesystem::path directory(this->directory);
+
+    std::ifstream input(directory / RENDERER_FILE);
+    std::string cachedRenderer;
+    std::getline(input, cachedRenderer);
+    input.close();
+
+    if (cachedRenderer == renderer) {
+        return;
+    }
+
+    // Mesa and NVIDIA key their entries by driver themselves, the context is live by now and
+    // its entries may already be in use, so the directory is left alone
+    std::ofstream output(directory / RENDERER_FILE);
+    output << renderer << "\n";
+}
+
+}  // namespace Rubik
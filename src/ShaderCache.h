@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <string>
+#include <cstdint>
+
+namespace Rubik {
+
+// On-disk program binary cache. Programs are compiled by the engine, so the cache is the driver's
+// own (Mesa, NVIDIA) pointed at <cache directory>/rubik-shaders/<hash of our shader sources>. Entries
+// of other source versions are removed by enable(). The drivers key their entries by renderer, so
+// setRenderer() only records the renderer that last used the cache.
+class ShaderCache {
+public:
+    ShaderCache(const std::string& shaderDirectory, const std::string& cacheDirectory);
+
+    const std::string& getDirectory() const;
+    uint64_t getSourceHash() const;
+
+    static std::string getDefaultDirectory();
+
+    bool enable();
+    void setRenderer(const std::string& renderer);
+
+private:
+    std::string directory;
+    uint64_t sourceHash;
+};
+
+}  // namespace Rubik
+
+#endif  // SHADERCACHE_H
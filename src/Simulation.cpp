@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Simulation.h>
+#include <Scrambler.h>
+#include <Session.h>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+
+namespace Rubik {
+
+Simulation::Simulation():
+        keys(0),
+        pressedKeys(0),
+        running(false) {
+    // Both queues keep their capacity across swaps, ticks don't allocate once these are big enough
+    this->commands.reserve(COMMANDS_CAPACITY);
+    this->pendingCommands.reserve(COMMANDS_CAPACITY);
+}
+
+Simulation::~Simulation() {
+    this->stop();
+}
+
+Puzzle& Simulation::getPuzzle() {
+    return this->puzzle;
+}
+
+SolveLog& Simulation::getSolveLog() {
+    return this->solveLog;
+}
+
+int Simulation::getShuffles() const {
+    return this->shuffles;
+}
+
+void Simulation::setShuffles(int shuffles) {
+    this->shuffles = shuffles;
+}
+
+bool Simulation::isRandomState() const {
+    return this->randomState;
+}
+
+void Simulation::setRandomState(bool randomState) {
+    this->randomState = randomState;
+}
+
+uint64_t Simulation::getSeed() const {
+    return this->seed;
+}
+
+void Simulation::setSeed(uint64_t seed) {
+    this->seed = seed;
+    std::srand(static_cast<unsigned int>(seed));
+}
+
+const std::string& Simulation::getSessionPath() const {
+    return this->sessionPath;
+}
+
+void Simulation::setSessionPath(const std::string& sessionPath) {
+    this->sessionPath = sessionPath;
+}
+
+bool Simulation::restoreSession() {
+    SessionRecord record;
+    if (this->sessionPath.empty() || !Session::read(this->sessionPath, record)) {
+        return false;
+    }
+
+    if (record.moves < 0 || !(record.gameTime >= 0.0f) || !this->puzzle.restore(record.puzzle)) {
+        return false;
+    }
+
+    // Scrambles are dealt from the seed by index, random turn shuffles continue from a reseeded rand()
+    this->setSeed(record.seed);
+    this->games = record.games;
+    this->moves = record.moves;
+    this->gameTime = record.gameTime;
+    this->state = GameState::PAUSED;
+    return true;
+}
+
+void Simulation::start() {
+    if (this->running) {
+        return;
+    }
+
+    // start() is called on the reading thread, so it takes the first snapshot itself and input
+    // events arriving before the first frame see the real puzzle
+    this->publish();
+    this->snapshots.update();
+    this->running = true;
+    this->thread = std::thread(&Simulation::run, this);
+}
+
+void Simulation::stop() {
+    this->running = false;
+    if (this->thread.joinable()) {
+        this->thread.join();
+        this->saveSession();
+    }
+}
+
+void Simulation::setKeys(unsigned int keys) {
+    this->keys = keys;
+}
+
+void Simulation::pressKeys(unsigned int keys) {
+    this->pressedKeys |= keys;
+}
+
+void Simulation::rotateCube(int objectId, float xDirection, float yDirection) {
+    std::lock_guard<std::mutex> lock(this->commandsMutex);
+    this->commands.push_back({ objectId, xDirection, yDirection });
+}
+
+bool Simulation::updateSnapshot() {
+    return this->snapshots.update();
+}
+
+const GameSnapshot& Simulation::getSnapshot() const {
+    return this->snapshots.getReadBuffer();
+}
+
+void Simulation::shufflePuzzle() {
+    if (this->randomState) {
+        Scrambler scrambler(this->seed);
+        this->puzzle.shuffle(scrambler.getScramble(this->games++));
+    } else {
+        this->puzzle.shuffle(this->shuffles);
+    }
+}
+
+void Simulation::step(float frameTime) {
+    unsigned int keys = this->keys;
+    unsigned int pressedKeys = this->pressedKeys.exchange(0);
+
+    switch (this->state) {
+        case GameState::RUNNING:
+            if ((pressedKeys & KEY_SPEEDUP) && this->rotationSpeed == 0.0f) {
+                this->rotationSpeed = this->puzzle.getRotationSpeed();
+                this->puzzle.setRotationSpeed(this->rotationSpeed * 2.0f);
+            } else if (!(keys & KEY_SPEEDUP) && this->rotationSpeed != 0.0f) {
+                this->puzzle.setRotationSpeed(this->rotationSpeed);
+                this->rotationSpeed = 0.0f;
+            }
+            // Fall through
+
+        case GameState::PAUSED:
+            if (pressedKeys & KEY_PAUSE) {
+                this->state = (this->state == GameState::RUNNING) ? GameState::PAUSED : GameState::RUNNING;
+                if (this->state == GameState::PAUSED) {
+                    this->saveSession();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->commandsMutex);
+        this->pendingCommands.swap(this->commands);
+    }
+    for (auto& command: this->pendingCommands) {
+        this->processRotation(command);
+    }
+    this->pendingCommands.clear();
+
+    switch (this->state) {
+        case GameState::RUNNING:
+            if (this->puzzle.isSolved()) {
+                this->state = GameState::FINISHED;
+                this->recordSolve();
+            } else if (keys & KEY_QUIT) {
+                this->state = GameState::QUIT;
+                this->saveSession();
+            } else if (keys & KEY_SPEEDUP) {
+                this->puzzle.selectCube(this->puzzle.getCubeId(std::rand() % Puzzle::CUBES));
+                this->puzzle.setAnimationState(static_cast<AnimationState>(std::rand() % 4 + 1));
+            }
+
+            this->puzzle.update(frameTime);
+            break;
+
+        case GameState::QUIT:
+            if (keys & KEY_YES) {
+                this->state = GameState::EXIT;
+            } else if (keys & KEY_NO) {
+                this->state = GameState::RUNNING;
+            }
+            break;
+
+        case GameState::FINISHED:
+            if (keys & KEY_NO) {
+                this->state = GameState::EXIT;
+            } else if (keys & KEY_YES) {
+                this->moves = 0;
+                this->gameTime = 0.0f;
+                this->state = GameState::RUNNING;
+                this->shufflePuzzle();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (this->state == GameState::RUNNING && !(keys & KEY_SPEEDUP)) {
+        this->gameTime += frameTime;
+    }
+}
+
+void Simulation::run() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / TICK_RATE));
+    Clock::time_point nextTick = Clock::now();
+
+    while (this->running) {
+        this->step(1.0f / TICK_RATE);
+        this->publish();
+
+        // Skip ticks missed while suspended rather than fast-forwarding through them
+        nextTick += tick;
+        Clock::time_point now = Clock::now();
+        if (now - nextTick > tick * TICK_RATE / 4) {
+            nextTick = now;
+        }
+
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void Simulation::publish() {
+    GameSnapshot& snapshot = this->snapshots.getWriteBuffer();
+
+    for (int cube = 0; cube < Puzzle::CUBES; cube++) {
+        snapshot.rotations[cube] = this->puzzle.getCubeRotation(cube);
+        snapshot.positions[cube] = this->puzzle.getCubeCell(cube);
+    }
+
+    if (!this->puzzle.getTurningLayer(snapshot.turnAxis, snapshot.turnLayer)) {
+        snapshot.turnAxis = -1;
+    }
+
+    snapshot.cubeState = this->puzzle.getState();
+    snapshot.frame = this->puzzle.getFrame();
+    snapshot.state = this->state;
+    snapshot.moves = this->moves;
+    snapshot.gameTime = this->gameTime;
+    snapshot.stats = this->solveLog.getStats();
+
+    this->snapshots.publish();
+}
+
+void Simulation::processRotation(const RotateCommand& command) {
+    if (this->state != GameState::RUNNING) {
+        return;  // No action on pause
+    }
+
+    if (std::hypot(command.xDirection, command.yDirection) < 1.5f) {
+        return;  // Movement is too short
+    }
+
+    if (command.objectId != -1 && this->puzzle.getAnimationState() == AnimationState::IDLE) {
+        this->moves++;
+    }
+
+    AnimationState puzzleState = AnimationState::IDLE;
+    if (std::fabs(command.xDirection) > std::fabs(command.yDirection)) {
+        puzzleState = (command.xDirection > 0) ? AnimationState::RIGHT_ROTATION : AnimationState::LEFT_ROTATION;
+    } else {
+        puzzleState = (command.yDirection > 0) ? AnimationState::DOWN_ROTATION : AnimationState::UP_ROTATION;
+    }
+
+    this->puzzle.selectCube(command.objectId);
+    this->puzzle.setAnimationState(puzzleState);
+}
+
+void Simulation::recordSolve() {
+    if (this->moves == 0 || this->gameTime <= 0.0f) {
+        return;  // Solved without the player
+    }
+
+    SolveRecord record;
+    record.date = static_cast<double>(std::time(nullptr));
+    record.time = this->gameTime;
+    record.moves = this->moves;
+    record.tps = this->moves / this->gameTime;
+    record.reserved = 0;
+    record.seed = this->seed;
+    record.scramble = this->randomState ? this->games - 1 : SolveLog::NO_SCRAMBLE;
+
+    this->solveLog.append(record);
+}
+
+void Simulation::saveSession() {
+    if (this->sessionPath.empty()) {
+        return;
+    }
+
+    if (this->state == GameState::FINISHED || this->puzzle.isSolved()) {
+        Session::remove(this->sessionPath);  // Nothing left to resume
+        return;
+    }
+
+    SessionRecord record;
+    record.seed = this->seed;
+    record.games = this->games;
+    record.moves = this->moves;
+    record.gameTime = this->gameTime;
+    this->puzzle.save(record.puzzle);
+
+    Session::write(this->sessionPath, record);
+}
+
+}  // namespace Rubik
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <Puzzle.h>
+#include <SolveLog.h>
+#include <Quaternion.h>
+#include <TripleBuffer.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace Rubik {
+
+enum class GameState { RUNNING, PAUSED, QUIT, FINISHED, EXIT };
+
+enum GameKey {
+    KEY_SPEEDUP = 1 << 0,
+    KEY_PAUSE   = 1 << 1,
+    KEY_QUIT    = 1 << 2,
+    KEY_YES     = 1 << 3,
+    KEY_NO      = 1 << 4
+};
+
+// Everything the render thread needs to draw a frame
+struct GameSnapshot {
+    Quaternion rotations[Puzzle::CUBES];
+    int positions[Puzzle::CUBES];  // Grid position i * 9 + j * 3 + k of each cube
+    int turnAxis;   // Grid axis of the layer being turned, -1 if none is
+    int turnLayer;
+    CubeState cubeState;  // Relative to the centers, frame turns it to the view
+    int frame;
+    GameState state;
+    int moves;
+    float gameTime;
+    SolveStats stats;
+};
+
+// Game logic on a fixed timestep thread. Input comes in through atomics and a short command
+// queue, results go out through a triple buffer, so a slow frame never stalls the animation and
+// the render thread never waits for a tick.
+class Simulation {
+public:
+    static const int TICK_RATE = 120;
+
+    Simulation();
+    ~Simulation();
+
+    Puzzle& getPuzzle();
+    SolveLog& getSolveLog();  // Open before start()
+
+    int getShuffles() const;
+    void setShuffles(int shuffles);
+
+    bool isRandomState() const;
+    void setRandomState(bool randomState);
+
+    uint64_t getSeed() const;
+    void setSeed(uint64_t seed);
+
+    // Game in progress saved on pause, on the quit prompt and on stop(), empty to keep none
+    const std::string& getSessionPath() const;
+    void setSessionPath(const std::string& sessionPath);
+
+    // Picks up the saved game paused instead of shuffling, false if there is none to restore
+    bool restoreSession();
+
+    void start();
+    void stop();
+
+    // Input, callable from any thread
+    void setKeys(unsigned int keys);
+    void pressKeys(unsigned int keys);
+    void rotateCube(int objectId, float xDirection, float yDirection);
+
+    bool updateSnapshot();
+    const GameSnapshot& getSnapshot() const;
+
+    void shufflePuzzle();
+    void step(float frameTime);
+
+private:
+    static const size_t COMMANDS_CAPACITY = 256;
+
+    struct RotateCommand {
+        int objectId;
+        float xDirection;
+        float yDirection;
+    };
+
+    void run();
+    void publish();
+    void processRotation(const RotateCommand& command);
+    void recordSolve();
+    void saveSession();
+
+    Puzzle puzzle;
+    SolveLog solveLog;
+    GameState state = GameState::RUNNING;
+    int moves = 0;
+    float gameTime = 0.0f;
+    float rotationSpeed = 0.0f;  // Normal speed while sped up, 0 otherwise
+
+    int shuffles = 20;
+    bool randomState = false;
+    uint64_t seed = 0;
+    uint64_t games = 0;
+    std::string sessionPath;
+
+    std::atomic<unsigned int> keys;
+    std::atomic<unsigned int> pressedKeys;
+    std::vector<RotateCommand> commands;
+    std::vector<RotateCommand> pendingCommands;
+    std::mutex commandsMutex;
+
+    TripleBuffer<GameSnapshot> snapshots;
+    std::atomic<bool> running;
+    std::thread thread;
+};
+
+}  // namespace Rubik
+
+#endif  // SIMULATION_H
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <SolveLog.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Rubik {
+
+static const uint32_t SOLVE_LOG_MAGIC = 0x474C5352;  // "RSLG"
+static const uint32_t SOLVE_LOG_VERSION = 2;
+static const uint64_t SOLVE_LOG_CAPACITY = 1024;  // Initial records, doubled when full
+
+SolveLog::RollingAverage::RollingAverage(int size, int trim):
+        recent(size),
+        size(size),
+        trim(trim) {
+    this->sorted.reserve(size);
+}
+
+void SolveLog::RollingAverage::add(float time) {
+    if (static_cast<int>(this->sorted.size()) == this->size) {
+        float oldest = this->recent[this->next];
+        this->sorted.erase(std::lower_bound(this->sorted.begin(), this->sorted.end(), oldest));
+        this->sum -= oldest;
+    }
+
+    this->sorted.insert(std::upper_bound(this->sorted.begin(), this->sorted.end(), time), time);
+    this->sum += time;
+
+    this->recent[this->next] = time;
+    this->next = (this->next + 1) % this->size;
+}
+
+float SolveLog::RollingAverage::get() const {
+    if (static_cast<int>(this->sorted.size()) < this->size) {
+        return -1.0f;
+    }
+
+    double trimmed = this->sum;
+    for (int i = 0; i < this->trim; i++) {
+        trimmed -= this->sorted[i] + this->sorted[this->size - 1 - i];
+    }
+
+    return static_cast<float>(trimmed / (this->size - 2 * this->trim));
+}
+
+SolveLog::SolveLog():
+        average5(5, 1),
+        average12(12, 1),
+        average100(100, 5) {
+    this->stats = { 0, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f };
+}
+
+SolveLog::~SolveLog() {
+    this->close();
+}
+
+// Logs aren't mapped on Windows, nothing to default to there
+std::string SolveLog::getDefaultPath() {
+#ifndef _WIN32
+    const char* data = std::getenv("XDG_DATA_HOME");
+    if (data != nullptr && *data != '\0') {
+        return (std::filesystem::path(data) / "rubik" / "solves.log").string();
+    }
+
+    const char* home = std::getenv("HOME");
+    if (home != nullptr && *home != '\0') {
+        return (std::filesystem::path(home) / ".local" / "share" / "rubik" / "solves.log").string();
+    }
+#endif
+
+    return "";
+}
+
+#ifdef _WIN32
+
+bool SolveLog::open(const std::string& /* filename */) {
+    return false;
+}
+
+void SolveLog::close() {
+}
+
+bool SolveLog::map(uint64_t /* capacity */) {
+    return false;
+}
+
+void SolveLog::unmap() {
+}
+
+#else
+
+bool SolveLog::open(const std::string& filename) {
+    this->close();
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(filename).parent_path(), error);
+
+    this->file = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->file == -1) {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(this->file, &status) == -1) {
+        this->close();
+        return false;
+    }
+
+    // Anything but an empty file or a log of ours is left exactly as it is
+    uint64_t capacity = SOLVE_LOG_CAPACITY;
+    bool created = (status.st_size == 0);
+
+    if (!created) {
+        Header header;
+        size_t size = static_cast<size_t>(status.st_size);
+        if (size < sizeof(Header) || pread(this->file, &header, sizeof(Header), 0) != static_cast<ssize_t>(sizeof(Header))) {
+            this->close();
+            return false;
+        }
+
+        capacity = (size - sizeof(Header)) / sizeof(SolveRecord);
+        if (header.magic != SOLVE_LOG_MAGIC || header.version != SOLVE_LOG_VERSION || header.current > 1 ||
+                header.totals[header.current].count > capacity) {
+            this->close();
+            return false;
+        }
+    }
+
+    if (!this->map(capacity)) {
+        this->close();
+        return false;
+    }
+
+    if (created) {
+        Totals totals = { 0, 0, 0.0, -1.0f, 0 };
+        *this->header = { SOLVE_LOG_MAGIC, SOLVE_LOG_VERSION, 0, 0, { totals, totals } };
+    }
+
+    const Totals& totals = this->header->totals[this->header->current];
+    this->stats = { totals.count, totals.best, -1.0f, -1.0f, -1.0f, -1.0f, -1.0f };
+    this->totalMoves = totals.moves;
+    this->totalTime = totals.time;
+
+    this->average5 = RollingAverage(5, 1);
+    this->average12 = RollingAverage(12, 1);
+    this->average100 = RollingAverage(100, 5);
+
+    uint64_t replay = std::min<uint64_t>(totals.count, 100);
+    for (uint64_t record = totals.count - replay; record < totals.count; record++) {
+        this->average5.add(this->records[record].time);
+        this->average12.add(this->records[record].time);
+        this->average100.add(this->records[record].time);
+    }
+
+    if (this->stats.count > 0) {
+        this->stats.mean = static_cast<float>(this->totalTime / this->stats.count);
+        this->stats.tps = static_cast<float>(this->totalMoves / this->totalTime);
+    }
+    this->stats.average5 = this->average5.get();
+    this->stats.average12 = this->average12.get();
+    this->stats.average100 = this->average100.get();
+    return true;
+}
+
+void SolveLog::close() {
+    this->unmap();
+
+    if (this->file != -1) {
+        ::close(this->file);
+        this->file = -1;
+    }
+}
+
+bool SolveLog::map(uint64_t capacity) {
+    this->unmap();
+
+    size_t size = sizeof(Header) + capacity * sizeof(SolveRecord);
+    if (ftruncate(this->file, size) == -1) {
+        return false;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->file, 0);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    this->header = static_cast<Header*>(memory);
+    this->records = reinterpret_cast<SolveRecord*>(static_cast<char*>(memory) + sizeof(Header));
+    this->capacity = capacity;
+    this->mappedSize = size;
+    return true;
+}
+
+void SolveLog::unmap() {
+    if (this->header != nullptr) {
+        munmap(this->header, this->mappedSize);
+        this->header = nullptr;
+        this->records = nullptr;
+        this->capacity = 0;
+        this->mappedSize = 0;
+    }
+}
+
+#endif
+
+void SolveLog::append(const SolveRecord& record) {
+    if (this->header != nullptr) {
+        uint64_t count = this->header->totals[this->header->current].count;
+        if (count == this->capacity && !this->map(std::max(count * 2, SOLVE_LOG_CAPACITY))) {
+            this->close();  // Growing failed, keep counting in memory
+        }
+    }
+
+    if (this->header != nullptr) {
+        uint32_t current = this->header->current;
+        Totals totals = this->header->totals[current];
+
+        this->records[totals.count] = record;
+        totals.count++;
+        totals.moves += record.moves;
+        totals.time += record.time;
+        if (totals.best < 0.0f || record.time < totals.best) {
+            totals.best = record.time;
+        }
+        this->header->totals[1 - current] = totals;
+
+        // Nothing above counts until this store, the compiler must not move it up
+        std::atomic_signal_fence(std::memory_order_release);
+        this->header->current = 1 - current;
+    }
+
+    this->update(record);
+}
+
+const SolveStats& SolveLog::getStats() const {
+    return this->stats;
+}
+
+void SolveLog::update(const SolveRecord& record) {
+    this->stats.count++;
+    this->totalMoves += record.moves;
+    this->totalTime += record.time;
+
+    if (this->stats.best < 0.0f || record.time < this->stats.best) {
+        this->stats.best = record.time;
+    }
+
+    this->average5.add(record.time);
+    this->average12.add(record.time);
+    this->average100.add(record.time);
+
+    this->stats.mean = static_cast<float>(this->totalTime / this->stats.count);
+    this->stats.tps = static_cast<float>(this->totalMoves / this->totalTime);
+    this->stats.average5 = this->average5.get();
+    this->stats.average12 = this->average12.get();
+    this->stats.average100 = this->average100.get();
+}
+
+}  // namespace Rubik
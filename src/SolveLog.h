@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SOLVELOG_H
+#define SOLVELOG_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Rubik {
+
+struct SolveRecord {
+    double date;        // Seconds since the epoch
+    float time;         // Seconds
+    int32_t moves;
+    float tps;
+    uint32_t reserved;
+    uint64_t seed;
+    uint64_t scramble;  // Scrambler index, NO_SCRAMBLE for random turn shuffles
+};
+
+struct SolveStats {
+    uint64_t count;
+    float best;     // Negative until there is a solve
+    float mean;
+    float tps;
+    float average5;   // Negative until there are enough solves
+    float average12;
+    float average100;
+};
+
+// Append-only memory-mapped log of finished solves. The header keeps running totals and opening
+// replays only the last 100 records, so neither startup nor append depends on the history size.
+// Without a file (or where mapping is unsupported) statistics are kept for the session only.
+// Open the log before appending to it, solves recorded earlier are not merged in.
+class SolveLog {
+public:
+    static const uint64_t NO_SCRAMBLE = UINT64_MAX;
+
+    SolveLog();
+    ~SolveLog();
+
+    SolveLog(const SolveLog&) = delete;
+    SolveLog& operator=(const SolveLog&) = delete;
+
+    static std::string getDefaultPath();
+
+    bool open(const std::string& filename);
+    void close();
+
+    void append(const SolveRecord& record);
+    const SolveStats& getStats() const;
+
+private:
+    // Running totals of the first count records. Appending fills in the spare copy and then
+    // switches current over to it, so a crash at any point leaves one consistent copy.
+    struct Totals {
+        uint64_t count;
+        uint64_t moves;
+        double time;
+        float best;
+        uint32_t reserved;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t current;  // Totals in effect, 0 or 1
+        uint32_t reserved;
+        Totals totals[2];
+    };
+
+    // WCA style average of the last size solves without the trim best and trim worst ones.
+    // Solves are kept both in arrival order and sorted, an update moves at most size values.
+    class RollingAverage {
+    public:
+        RollingAverage(int size, int trim);
+
+        void add(float time);
+        float get() const;
+
+    private:
+        std::vector<float> recent;
+        std::vector<float> sorted;
+        int size;
+        int trim;
+        int next = 0;
+        double sum = 0.0;
+    };
+
+    bool map(uint64_t capacity);
+    void unmap();
+    void update(const SolveRecord& record);
+
+    Header* header = nullptr;
+    SolveRecord* records = nullptr;
+    uint64_t capacity = 0;  // Records the mapped file has room for
+    size_t mappedSize = 0;
+    int file = -1;
+
+    SolveStats stats;
+    uint64_t totalMoves = 0;
+    double totalTime = 0.0;
+    RollingAverage average5;
+    RollingAverage average12;
+    RollingAverage average100;
+};
+
+}  // namespace Rubik
+
+#endif  // SOLVELOG_H
@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Solver.h>
+#include <StateRank.h>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+namespace Rubik {
+
+namespace {
+
+const int TWISTS = 2187;        // 3^7
+const int FLIPS = 2048;         // 2^11
+const int SLICES = 495;         // C(12, 4)
+const int SLICE_SORTED = 11880; // 12! / 8!
+const int SLICE_PERMUTATIONS = 24;
+const int CORNER_PERMUTATIONS = 40320;
+const int EDGE_PERMUTATIONS = 40320;
+
+const int PHASE2_MAX_LENGTH = 18;
+const int PHASE2_MOVES = 10;
+
+const Move phase2Moves[PHASE2_MOVES] = {
+    Move::U, Move::U2, Move::U3, Move::D, Move::D2, Move::D3, Move::R2, Move::L2, Move::F2, Move::B2
+};
+
+int binomial(int n, int k) {
+    if (k < 0 || k > n) {
+        return 0;
+    }
+
+    int result = 1;
+    for (int i = 1; i <= k; i++) {
+        result = result * (n - k + i) / i;
+    }
+
+    return result;
+}
+
+int getTwist(const CubeState& state) {
+    int twist = 0;
+    for (int i = 0; i < CubeState::CORNERS - 1; i++) {
+        twist = twist * 3 + state.getCornerOrientation(i);
+    }
+
+    return twist;
+}
+
+void setTwist(CubeState& state, int twist) {
+    int total = 0;
+    for (int i = CubeState::CORNERS - 2; i >= 0; i--) {
+        state.setCorner(i, state.getCorner(i), twist % 3);
+        total += twist % 3;
+        twist /= 3;
+    }
+
+    state.setCorner(CubeState::CORNERS - 1, state.getCorner(CubeState::CORNERS - 1), (3 - total % 3) % 3);
+}
+
+int getFlip(const CubeState& state) {
+    int flip = 0;
+    for (int i = 0; i < CubeState::EDGES - 1; i++) {
+        flip = flip * 2 + state.getEdgeOrientation(i);
+    }
+
+    return flip;
+}
+
+void setFlip(CubeState& state, int flip) {
+    int total = 0;
+    for (int i = CubeState::EDGES - 2; i >= 0; i--) {
+        state.setEdge(i, state.getEdge(i), flip % 2);
+        total += flip % 2;
+        flip /= 2;
+    }
+
+    state.setEdge(CubeState::EDGES - 1, state.getEdge(CubeState::EDGES - 1), total % 2);
+}
+
+// Positions of the FR, FL, BL, BR edges (combination) and their order (permutation), 0 when in the E slice
+int getSliceSorted(const CubeState& state) {
+    int combination = 0;
+    int order[4];
+    int found = 0;
+
+    for (int slot = CubeState::EDGES - 1; slot >= 0; slot--) {
+        int edge = state.getEdge(slot);
+        if (edge >= 8) {
+            combination += binomial(CubeState::EDGES - 1 - slot, found + 1);
+            order[3 - found++] = edge - 8;
+        }
+    }
+
+    return combination * SLICE_PERMUTATIONS + static_cast<int>(StateRank::rankPermutation(order, 4));
+}
+
+void setSliceSorted(CubeState& state, int sliceSorted) {
+    int combination = sliceSorted / SLICE_PERMUTATIONS;
+    int order[4];
+    StateRank::unrankPermutation(sliceSorted % SLICE_PERMUTATIONS, order, 4);
+
+    bool sliceSlot[CubeState::EDGES] = {};
+    for (int i = 3; i >= 0; i--) {
+        int x = i;
+        while (binomial(x + 1, i + 1) <= combination) {
+            x++;
+        }
+
+        combination -= binomial(x, i + 1);
+        sliceSlot[CubeState::EDGES - 1 - x] = true;
+    }
+
+    int sliceEdge = 0;
+    int otherEdge = 0;
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        state.setEdge(slot, sliceSlot[slot] ? order[sliceEdge++] + 8 : otherEdge++, 0);
+    }
+}
+
+int getCornerPermutation(const CubeState& state) {
+    int corners[CubeState::CORNERS];
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        corners[i] = state.getCorner(i);
+    }
+
+    return static_cast<int>(StateRank::rankPermutation(corners, CubeState::CORNERS));
+}
+
+void setCornerPermutation(CubeState& state, int permutation) {
+    int corners[CubeState::CORNERS];
+    StateRank::unrankPermutation(permutation, corners, CubeState::CORNERS);
+
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        state.setCorner(i, corners[i], 0);
+    }
+}
+
+// Permutation of the U and D layer edges, only defined within the phase 2 subgroup
+int getEdgePermutation(const CubeState& state) {
+    int edges[8];
+    for (int i = 0; i < 8; i++) {
+        edges[i] = state.getEdge(i);
+    }
+
+    return static_cast<int>(StateRank::rankPermutation(edges, 8));
+}
+
+void setEdgePermutation(CubeState& state, int permutation) {
+    int edges[8];
+    StateRank::unrankPermutation(permutation, edges, 8);
+
+    for (int i = 0; i < CubeState::EDGES; i++) {
+        state.setEdge(i, (i < 8) ? edges[i] : i, 0);
+    }
+}
+
+template<typename Next>
+void buildPruning(std::vector<int8_t>& pruning, int size, int moves, Next next) {
+    pruning.assign(size, -1);
+    pruning[0] = 0;
+
+    std::vector<int> frontier(1, 0);
+    for (int8_t depth = 1; !frontier.empty(); depth++) {
+        std::vector<int> nextFrontier;
+
+        for (int index: frontier) {
+            for (int move = 0; move < moves; move++) {
+                int nextIndex = next(index, move);
+                if (pruning[nextIndex] == -1) {
+                    pruning[nextIndex] = depth;
+                    nextFrontier.push_back(nextIndex);
+                }
+            }
+        }
+
+        frontier.swap(nextFrontier);
+    }
+}
+
+class Tables {
+public:
+    Tables():
+            twistMove(TWISTS * CubeState::MOVES),
+            flipMove(FLIPS * CubeState::MOVES),
+            sliceSortedMove(SLICE_SORTED * CubeState::MOVES),
+            cornerMove(CORNER_PERMUTATIONS * CubeState::MOVES),
+            edgeMove(EDGE_PERMUTATIONS * PHASE2_MOVES) {
+        this->buildMoves(this->twistMove, TWISTS, setTwist, getTwist);
+        this->buildMoves(this->flipMove, FLIPS, setFlip, getFlip);
+        this->buildMoves(this->sliceSortedMove, SLICE_SORTED, setSliceSorted, getSliceSorted);
+        this->buildMoves(this->cornerMove, CORNER_PERMUTATIONS, setCornerPermutation, getCornerPermutation);
+
+        for (int i = 0; i < EDGE_PERMUTATIONS; i++) {
+            for (int move = 0; move < PHASE2_MOVES; move++) {
+                CubeState state;
+                setEdgePermutation(state, i);
+                state.applyMove(phase2Moves[move]);
+                this->edgeMove[i * PHASE2_MOVES + move] = static_cast<uint16_t>(getEdgePermutation(state));
+            }
+        }
+
+        buildPruning(this->twistSlicePruning, TWISTS * SLICES, CubeState::MOVES, [this](int index, int move) {
+            return this->getTwistMove(index / SLICES, move) * SLICES + this->getSliceMove(index % SLICES, move);
+        });
+
+        buildPruning(this->flipSlicePruning, FLIPS * SLICES, CubeState::MOVES, [this](int index, int move) {
+            return this->getFlipMove(index / SLICES, move) * SLICES + this->getSliceMove(index % SLICES, move);
+        });
+
+        buildPruning(this->cornerSlicePruning, CORNER_PERMUTATIONS * SLICE_PERMUTATIONS, PHASE2_MOVES, [this](int index, int move) {
+            int phase1Move = static_cast<int>(phase2Moves[move]);
+            return this->getCornerMove(index / SLICE_PERMUTATIONS, phase1Move) * SLICE_PERMUTATIONS +
+                   this->getSliceSortedMove(index % SLICE_PERMUTATIONS, phase1Move);
+        });
+
+        buildPruning(this->edgeSlicePruning, EDGE_PERMUTATIONS * SLICE_PERMUTATIONS, PHASE2_MOVES, [this](int index, int move) {
+            int phase1Move = static_cast<int>(phase2Moves[move]);
+            return this->getEdgeMove(index / SLICE_PERMUTATIONS, move) * SLICE_PERMUTATIONS +
+                   this->getSliceSortedMove(index % SLICE_PERMUTATIONS, phase1Move);
+        });
+    }
+
+    int getTwistMove(int twist, int move) const {
+        return this->twistMove[twist * CubeState::MOVES + move];
+    }
+
+    int getFlipMove(int flip, int move) const {
+        return this->flipMove[flip * CubeState::MOVES + move];
+    }
+
+    int getSliceMove(int slice, int move) const {
+        return this->getSliceSortedMove(slice * SLICE_PERMUTATIONS, move) / SLICE_PERMUTATIONS;
+    }
+
+    int getSliceSortedMove(int sliceSorted, int move) const {
+        return this->sliceSortedMove[sliceSorted * CubeState::MOVES + move];
+    }
+
+    int getCornerMove(int permutation, int move) const {
+        return this->cornerMove[permutation * CubeState::MOVES + move];
+    }
+
+    int getEdgeMove(int permutation, int phase2Move) const {
+        return this->edgeMove[permutation * PHASE2_MOVES + phase2Move];
+    }
+
+    int getPhase1Distance(int twist, int flip, int slice) const {
+        return std::max(this->twistSlicePruning[twist * SLICES + slice], this->flipSlicePruning[flip * SLICES + slice]);
+    }
+
+    int getPhase2Distance(int corners, int edges, int slice) const {
+        return std::max(this->cornerSlicePruning[corners * SLICE_PERMUTATIONS + slice],
+                        this->edgeSlicePruning[edges * SLICE_PERMUTATIONS + slice]);
+    }
+
+private:
+    template<typename Set, typename Get>
+    void buildMoves(std::vector<uint16_t>& table, int size, Set set, Get get) {
+        for (int i = 0; i < size; i++) {
+            CubeState state;
+            set(state, i);
+
+            for (int move = 0; move < CubeState::MOVES; move++) {
+                CubeState moved(state);
+                moved.applyMove(static_cast<Move>(move));
+                table[i * CubeState::MOVES + move] = static_cast<uint16_t>(get(moved));
+            }
+        }
+    }
+
+    std::vector<uint16_t> twistMove;
+    std::vector<uint16_t> flipMove;
+    std::vector<uint16_t> sliceSortedMove;
+    std::vector<uint16_t> cornerMove;
+    std::vector<uint16_t> edgeMove;
+
+    std::vector<int8_t> twistSlicePruning;
+    std::vector<int8_t> flipSlicePruning;
+    std::vector<int8_t> cornerSlicePruning;
+    std::vector<int8_t> edgeSlicePruning;
+};
+
+const Tables& getTables() {
+    static const Tables tables;
+    return tables;
+}
+
+bool isRedundant(int move, int previousMove) {
+    int face = move / 3;
+    int previousFace = previousMove / 3;
+
+    // Same face twice or opposite faces in the non-canonical order
+    return (face == previousFace || face + 3 == previousFace);
+}
+
+class Search {
+public:
+    Search(const CubeState& state, int maxLength):
+            tables(getTables()),
+            state(state),
+            maxLength(maxLength) {
+    }
+
+    bool run(std::vector<Move>& solution) {
+        int twist = getTwist(this->state);
+        int flip = getFlip(this->state);
+        int slice = getSliceSorted(this->state) / SLICE_PERMUTATIONS;
+
+        // Phase 1 alone never needs more than 12 moves, longer phase 1 solutions are still tried
+        // since they can leave a shorter phase 2
+        for (int depth = this->tables.getPhase1Distance(twist, flip, slice); depth <= this->maxLength; depth++) {
+            if (this->searchPhase1(twist, flip, slice, 0, depth)) {
+                solution.clear();
+                for (int i = 0; i < this->length; i++) {
+                    solution.push_back(static_cast<Move>(this->moves[i]));
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    bool searchPhase1(int twist, int flip, int slice, int depth, int remaining) {
+        if (remaining == 0) {
+            // A phase 2 move at the end means a shorter phase 1 solution was already tried
+            if (depth > 0 && std::find(phase2Moves, phase2Moves + PHASE2_MOVES, static_cast<Move>(this->moves[depth - 1])) !=
+                    phase2Moves + PHASE2_MOVES) {
+                return false;
+            }
+
+            return this->startPhase2(depth);
+        }
+
+        for (int move = 0; move < CubeState::MOVES; move++) {
+            if (depth > 0 && isRedundant(move, this->moves[depth - 1])) {
+                continue;
+            }
+
+            int nextTwist = this->tables.getTwistMove(twist, move);
+            int nextFlip = this->tables.getFlipMove(flip, move);
+            int nextSlice = this->tables.getSliceMove(slice, move);
+
+            if (this->tables.getPhase1Distance(nextTwist, nextFlip, nextSlice) >= remaining) {
+                continue;
+            }
+
+            this->moves[depth] = move;
+            if (this->searchPhase1(nextTwist, nextFlip, nextSlice, depth + 1, remaining - 1)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool startPhase2(int phase1Length) {
+        CubeState subgroupState(this->state);
+        for (int i = 0; i < phase1Length; i++) {
+            subgroupState.applyMove(static_cast<Move>(this->moves[i]));
+        }
+
+        int corners = getCornerPermutation(subgroupState);
+        int edges = getEdgePermutation(subgroupState);
+        int slice = getSliceSorted(subgroupState);
+
+        int maxDepth = std::min(this->maxLength - phase1Length, PHASE2_MAX_LENGTH);
+        for (int depth = this->tables.getPhase2Distance(corners, edges, slice); depth <= maxDepth; depth++) {
+            if (this->searchPhase2(corners, edges, slice, phase1Length, depth)) {
+                this->length = phase1Length + depth;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool searchPhase2(int corners, int edges, int slice, int depth, int remaining) {
+        if (remaining == 0) {
+            return (corners == 0 && edges == 0 && slice == 0);
+        }
+
+        for (int phase2Move = 0; phase2Move < PHASE2_MOVES; phase2Move++) {
+            int move = static_cast<int>(phase2Moves[phase2Move]);
+            if (depth > 0 && isRedundant(move, this->moves[depth - 1])) {
+                continue;
+            }
+
+            int nextCorners = this->tables.getCornerMove(corners, move);
+            int nextEdges = this->tables.getEdgeMove(edges, phase2Move);
+            int nextSlice = this->tables.getSliceSortedMove(slice, move);
+
+            if (this->tables.getPhase2Distance(nextCorners, nextEdges, nextSlice) >= remaining) {
+                continue;
+            }
+
+            this->moves[depth] = move;
+            if (this->searchPhase2(nextCorners, nextEdges, nextSlice, depth + 1, remaining - 1)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    const Tables& tables;
+    const CubeState& state;
+    int maxLength;
+
+    int moves[Solver::MAX_LENGTH];
+    int length = 0;
+};
+
+}  // namespace
+
+Solver::Solver() {
+    getTables();  // Build tables upfront rather than on the first solve
+}
+
+const int Solver::MAX_LENGTH;
+
+bool Solver::solve(const CubeState& state, int maxLength, std::vector<Move>& solution) const {
+    if (!state.isValid()) {
+        throw std::invalid_argument("solve(): unsolvable cube state");
+    }
+
+    Search search(state, std::min(maxLength, Solver::MAX_LENGTH));
+    return search.run(solution);
+}
+
+}  // namespace Rubik
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <CubeState.h>
+#include <vector>
+
+namespace Rubik {
+
+// Two-phase solver: reach the <U, D, R2, L2, F2, B2> subgroup first, then solve within it.
+// Move and pruning tables are built once per process and shared by all instances, so solve()
+// may be called from several threads at once.
+class Solver {
+public:
+    static const int MAX_LENGTH = 30;
+
+    Solver();
+
+    bool solve(const CubeState& state, int maxLength, std::vector<Move>& solution) const;
+};
+
+}  // namespace Rubik
+
+#endif  // SOLVER_H
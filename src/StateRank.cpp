@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <StateRank.h>
+#include <stdexcept>
+
+namespace Rubik {
+
+StateRank::StateRank():
+        corners(0),
+        edges(0) {
+}
+
+StateRank::StateRank(uint64_t corners, uint64_t edges):
+        corners(corners),
+        edges(edges) {
+    if (corners >= StateRank::CORNER_STATES || edges >= StateRank::REACHABLE_EDGE_STATES) {
+        throw std::out_of_range("StateRank(): rank out of range");
+    }
+}
+
+StateRank::StateRank(const CubeState& state):
+        corners(StateRank::rankCorners(state)) {
+    uint64_t edges = StateRank::rankEdges(state);
+    uint64_t flip = edges % 2048;
+
+    // The lowest Lehmer digit (0 or 1, the order of the last two edges) is not the parity itself, but
+    // with all other digits fixed, it follows from the parity, which always matches the corners
+    this->edges = edges / 2048 / 2 * 2048 + flip;
+}
+
+uint64_t StateRank::getCorners() const {
+    return this->corners;
+}
+
+uint64_t StateRank::getEdges() const {
+    return this->edges;
+}
+
+CubeState StateRank::getState() const {
+    CubeState state;
+    StateRank::unrankCorners(this->corners, state);
+    StateRank::unrankEdges(this->edges / 2048 * 2 * 2048 + this->edges % 2048, state);
+
+    if (state.getEdgeParity() != state.getCornerParity()) {
+        int last = CubeState::EDGES - 1;
+        int edge = state.getEdge(last);
+
+        state.setEdge(last, state.getEdge(last - 1), state.getEdgeOrientation(last));
+        state.setEdge(last - 1, edge, state.getEdgeOrientation(last - 1));
+    }
+
+    return state;
+}
+
+uint64_t StateRank::rankCorners(const CubeState& state) {
+    int corners[CubeState::CORNERS];
+    uint64_t twist = 0;
+
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        corners[i] = state.getCorner(i);
+        if (i < CubeState::CORNERS - 1) {
+            twist = twist * 3 + state.getCornerOrientation(i);
+        }
+    }
+
+    return StateRank::rankPermutation(corners, CubeState::CORNERS) * 2187 + twist;
+}
+
+void StateRank::unrankCorners(uint64_t rank, CubeState& state) {
+    if (rank >= StateRank::CORNER_STATES) {
+        throw std::out_of_range("unrankCorners(): rank out of range");
+    }
+
+    int corners[CubeState::CORNERS];
+    StateRank::unrankPermutation(rank / 2187, corners, CubeState::CORNERS);
+
+    int orientations[CubeState::CORNERS];
+    int twist = static_cast<int>(rank % 2187);
+    int total = 0;
+
+    for (int i = CubeState::CORNERS - 2; i >= 0; i--) {
+        orientations[i] = twist % 3;
+        total += twist % 3;
+        twist /= 3;
+    }
+
+    orientations[CubeState::CORNERS - 1] = (3 - total % 3) % 3;
+
+    for (int i = 0; i < CubeState::CORNERS; i++) {
+        state.setCorner(i, corners[i], orientations[i]);
+    }
+}
+
+uint64_t StateRank::rankEdges(const CubeState& state) {
+    int edges[CubeState::EDGES];
+    uint64_t flip = 0;
+
+    for (int i = 0; i < CubeState::EDGES; i++) {
+        edges[i] = state.getEdge(i);
+        if (i < CubeState::EDGES - 1) {
+            flip = flip * 2 + state.getEdgeOrientation(i);
+        }
+    }
+
+    return StateRank::rankPermutation(edges, CubeState::EDGES) * 2048 + flip;
+}
+
+void StateRank::unrankEdges(uint64_t rank, CubeState& state) {
+    if (rank >= StateRank::EDGE_STATES) {
+        throw std::out_of_range("unrankEdges(): rank out of range");
+    }
+
+    int edges[CubeState::EDGES];
+    StateRank::unrankPermutation(rank / 2048, edges, CubeState::EDGES);
+
+    int orientations[CubeState::EDGES];
+    int flip = static_cast<int>(rank % 2048);
+    int total = 0;
+
+    for (int i = CubeState::EDGES - 2; i >= 0; i--) {
+        orientations[i] = flip % 2;
+        total += flip % 2;
+        flip /= 2;
+    }
+
+    orientations[CubeState::EDGES - 1] = total % 2;
+
+    for (int i = 0; i < CubeState::EDGES; i++) {
+        state.setEdge(i, edges[i], orientations[i]);
+    }
+}
+
+uint64_t StateRank::rankPermutation(const int* permutation, int size) {
+    uint64_t rank = 0;
+    unsigned int seen = 0;
+
+    for (int i = 0; i < size; i++) {
+        // Lehmer digit: values right of i which are smaller, i.e. smaller ones not seen yet
+        unsigned int smallerSeen = seen & ((1u << permutation[i]) - 1);
+        int digit = permutation[i];
+
+        for (; smallerSeen != 0; smallerSeen &= smallerSeen - 1) {
+            digit--;
+        }
+
+        rank = rank * (size - i) + digit;
+        seen |= 1u << permutation[i];
+    }
+
+    return rank;
+}
+
+void StateRank::unrankPermutation(uint64_t rank, int* permutation, int size) {
+    if (size > CubeState::EDGES) {
+        throw std::out_of_range("unrankPermutation(): permutation too long");
+    }
+
+    int digits[CubeState::EDGES];
+    for (int i = size - 1; i >= 0; i--) {
+        digits[i] = static_cast<int>(rank % (size - i));
+        rank /= (size - i);
+    }
+
+    unsigned int used = 0;
+    for (int i = 0; i < size; i++) {
+        int value = -1;
+        for (int skip = digits[i]; skip >= 0; skip--) {
+            do {
+                value++;
+            } while ((used & (1u << value)) != 0);
+        }
+
+        permutation[i] = value;
+        used |= 1u << value;
+    }
+}
+
+void StateRank::rank(const CubeState* states, size_t count, StateRank* ranks) {
+    for (size_t i = 0; i < count; i++) {
+        ranks[i] = StateRank(states[i]);
+    }
+}
+
+void StateRank::unrank(const StateRank* ranks, size_t count, CubeState* states) {
+    for (size_t i = 0; i < count; i++) {
+        states[i] = ranks[i].getState();
+    }
+}
+
+bool StateRank::operator==(const StateRank& other) const {
+    return (this->corners == other.corners && this->edges == other.edges);
+}
+
+bool StateRank::operator!=(const StateRank& other) const {
+    return !(*this == other);
+}
+
+bool StateRank::operator<(const StateRank& other) const {
+    return (this->corners < other.corners || (this->corners == other.corners && this->edges < other.edges));
+}
+
+}  // namespace Rubik
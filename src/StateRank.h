@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STATERANK_H
+#define STATERANK_H
+
+#include <CubeState.h>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace Rubik {
+
+// Perfect hash of a CubeState. The 4.3 * 10^19 reachable states do not fit a single 64 bit word,
+// so the rank is kept as a corner part (Lehmer code * 3^7 + twist) and an edge part (Lehmer code
+// without its lowest digit, which the corner parity determines, * 2^11 + flip). Both parts are
+// dense, so getCorners() * REACHABLE_EDGE_STATES + getEdges() is a bijection onto
+// 0..CORNER_STATES * REACHABLE_EDGE_STATES - 1, a number that only fits the two words.
+class StateRank {
+public:
+    static const uint64_t CORNER_STATES = 88179840ull;      // 8! * 3^7
+    static const uint64_t EDGE_STATES = 980995276800ull;    // 12! * 2^11
+    static const uint64_t REACHABLE_EDGE_STATES = EDGE_STATES / 2;
+
+    StateRank();
+    StateRank(uint64_t corners, uint64_t edges);
+    explicit StateRank(const CubeState& state);
+
+    uint64_t getCorners() const;
+    uint64_t getEdges() const;
+
+    CubeState getState() const;
+
+    static uint64_t rankCorners(const CubeState& state);
+    static void unrankCorners(uint64_t rank, CubeState& state);
+
+    static uint64_t rankEdges(const CubeState& state);
+    static void unrankEdges(uint64_t rank, CubeState& state);
+
+    static uint64_t rankPermutation(const int* permutation, int size);
+    static void unrankPermutation(uint64_t rank, int* permutation, int size);
+
+    static void rank(const CubeState* states, size_t count, StateRank* ranks);
+    static void unrank(const StateRank* ranks, size_t count, CubeState* states);
+
+    bool operator==(const StateRank& other) const;
+    bool operator!=(const StateRank& other) const;
+    bool operator<(const StateRank& other) const;
+
+private:
+    uint64_t corners;
+    uint64_t edges;
+};
+
+}  // namespace Rubik
+
+namespace std {
+
+template<>
+struct hash<Rubik::StateRank> {
+    size_t operator()(const Rubik::StateRank& rank) const {
+        return static_cast<size_t>(rank.getCorners() * Rubik::StateRank::REACHABLE_EDGE_STATES + rank.getEdges());
+    }
+};
+
+}  // namespace std
+
+#endif  // STATERANK_H
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Symmetry.h>
+#include <StateRank.h>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+namespace Rubik {
+
+namespace {
+
+Face opposite(Face face) {
+    return static_cast<Face>((static_cast<int>(face) + 3) % 6);
+}
+
+// Where every slot facelet ends up, derived from the face permutation alone
+template<size_t S, size_t N>
+void mapFacelets(const std::array<Face, 6>& faces, Face (*getFacelet)(int, int), uint8_t (&slots)[S], uint8_t (&facelets)[S][N]) {
+    for (size_t slot = 0; slot < S; slot++) {
+        for (size_t target = 0; target < S; target++) {
+            bool matches = true;
+            for (size_t facelet = 0; facelet < N && matches; facelet++) {
+                Face face = faces[static_cast<int>(getFacelet(static_cast<int>(slot), static_cast<int>(facelet)))];
+                matches = false;
+
+                for (size_t targetFacelet = 0; targetFacelet < N; targetFacelet++) {
+                    if (getFacelet(static_cast<int>(target), static_cast<int>(targetFacelet)) == face) {
+                        facelets[slot][facelet] = static_cast<uint8_t>(targetFacelet);
+                        matches = true;
+                    }
+                }
+            }
+
+            if (matches) {
+                slots[slot] = static_cast<uint8_t>(target);
+                break;
+            }
+        }
+    }
+}
+
+class SymmetryTable {
+public:
+    SymmetryTable() {
+        std::vector<std::array<Face, 6>> rotations;
+        std::vector<std::array<Face, 6>> mirrors;
+
+        for (int up = 0; up < 6; up++) {
+            for (int right = 0; right < 6; right++) {
+                for (int front = 0; front < 6; front++) {
+                    if (right % 3 == up % 3 || front % 3 == up % 3 || front % 3 == right % 3) {
+                        continue;
+                    }
+
+                    std::array<Face, 6> faces;
+                    faces[static_cast<int>(Face::U)] = static_cast<Face>(up);
+                    faces[static_cast<int>(Face::R)] = static_cast<Face>(right);
+                    faces[static_cast<int>(Face::F)] = static_cast<Face>(front);
+                    faces[static_cast<int>(Face::D)] = opposite(static_cast<Face>(up));
+                    faces[static_cast<int>(Face::L)] = opposite(static_cast<Face>(right));
+                    faces[static_cast<int>(Face::B)] = opposite(static_cast<Face>(front));
+
+                    // Rotations keep the clockwise facelet order of the URF corner, mirrors reverse it
+                    uint8_t slots[CubeState::CORNERS];
+                    uint8_t facelets[CubeState::CORNERS][3];
+                    mapFacelets(faces, CubeState::getCornerFacelet, slots, facelets);
+
+                    bool isMirror = ((facelets[0][0] + 1) % 3 != facelets[0][1]);
+                    (isMirror ? mirrors : rotations).push_back(faces);
+                }
+            }
+        }
+
+        std::copy(rotations.begin(), rotations.end(), this->faces);
+        std::copy(mirrors.begin(), mirrors.end(), this->faces + Symmetry::ROTATIONS);
+
+        for (int symmetry = 0; symmetry < Symmetry::SYMMETRIES; symmetry++) {
+            mapFacelets(this->faces[symmetry], CubeState::getCornerFacelet, this->cornerSlots[symmetry], this->cornerFacelets[symmetry]);
+            mapFacelets(this->faces[symmetry], CubeState::getEdgeFacelet, this->edgeSlots[symmetry], this->edgeFacelets[symmetry]);
+        }
+
+        for (int first = 0; first < Symmetry::SYMMETRIES; first++) {
+            for (int second = 0; second < Symmetry::SYMMETRIES; second++) {
+                std::array<Face, 6> product;
+                for (int face = 0; face < 6; face++) {
+                    product[face] = this->faces[first][static_cast<int>(this->faces[second][face])];
+                }
+
+                this->products[first][second] = this->find(product);
+                if (this->products[first][second] == 0) {
+                    this->inverses[first] = second;
+                }
+            }
+
+            for (int move = 0; move < CubeState::MOVES; move++) {
+                int face = static_cast<int>(this->faces[first][move / 3]);
+                int turns = (first >= Symmetry::ROTATIONS) ? 2 - move % 3 : move % 3;
+                this->moves[first][move] = static_cast<Move>(face * 3 + turns);
+            }
+        }
+    }
+
+    int find(const std::array<Face, 6>& faces) const {
+        return static_cast<int>(std::find(this->faces, this->faces + Symmetry::SYMMETRIES, faces) - this->faces);
+    }
+
+    std::array<Face, 6> faces[Symmetry::SYMMETRIES];
+    int products[Symmetry::SYMMETRIES][Symmetry::SYMMETRIES];
+    int inverses[Symmetry::SYMMETRIES];
+    Move moves[Symmetry::SYMMETRIES][CubeState::MOVES];
+
+    uint8_t cornerSlots[Symmetry::SYMMETRIES][CubeState::CORNERS];
+    uint8_t cornerFacelets[Symmetry::SYMMETRIES][CubeState::CORNERS][3];
+    uint8_t edgeSlots[Symmetry::SYMMETRIES][CubeState::EDGES];
+    uint8_t edgeFacelets[Symmetry::SYMMETRIES][CubeState::EDGES][2];
+};
+
+const SymmetryTable& getSymmetryTable() {
+    static const SymmetryTable symmetryTable;
+    return symmetryTable;
+}
+
+}  // namespace
+
+int Symmetry::find(Face up, Face right, Face front) {
+    const SymmetryTable& table = getSymmetryTable();
+    for (int symmetry = 0; symmetry < Symmetry::SYMMETRIES; symmetry++) {
+        const std::array<Face, 6>& faces = table.faces[symmetry];
+        if (faces[static_cast<int>(Face::U)] == up && faces[static_cast<int>(Face::R)] == right && faces[static_cast<int>(Face::F)] == front) {
+            return symmetry;
+        }
+    }
+
+    return -1;
+}
+
+Face Symmetry::getFace(int symmetry, Face face) {
+    return getSymmetryTable().faces[symmetry][static_cast<int>(face)];
+}
+
+bool Symmetry::isMirror(int symmetry) {
+    return (symmetry >= Symmetry::ROTATIONS);
+}
+
+int Symmetry::multiply(int first, int second) {
+    return getSymmetryTable().products[first][second];
+}
+
+int Symmetry::inverse(int symmetry) {
+    return getSymmetryTable().inverses[symmetry];
+}
+
+Move Symmetry::conjugate(int symmetry, Move move) {
+    return getSymmetryTable().moves[symmetry][static_cast<int>(move)];
+}
+
+CubeState Symmetry::conjugate(int symmetry, const CubeState& state) {
+    const SymmetryTable& table = getSymmetryTable();
+    int inverse = table.inverses[symmetry];
+    CubeState conjugate;
+
+    int cornerSlots[CubeState::CORNERS];
+    for (int slot = 0; slot < CubeState::CORNERS; slot++) {
+        cornerSlots[state.getCorner(slot)] = slot;
+    }
+
+    // Follow the reference facelet of every cubie back through the inverse, the state and the symmetry
+    for (int corner = 0; corner < CubeState::CORNERS; corner++) {
+        int source = table.cornerSlots[inverse][corner];
+        int slot = cornerSlots[source];
+        int facelet = (state.getCornerOrientation(slot) + table.cornerFacelets[inverse][corner][0]) % 3;
+        conjugate.setCorner(table.cornerSlots[symmetry][slot], corner, table.cornerFacelets[symmetry][slot][facelet]);
+    }
+
+    int edgeSlots[CubeState::EDGES];
+    for (int slot = 0; slot < CubeState::EDGES; slot++) {
+        edgeSlots[state.getEdge(slot)] = slot;
+    }
+
+    for (int edge = 0; edge < CubeState::EDGES; edge++) {
+        int source = table.edgeSlots[inverse][edge];
+        int slot = edgeSlots[source];
+        int facelet = (state.getEdgeOrientation(slot) + table.edgeFacelets[inverse][edge][0]) % 2;
+        conjugate.setEdge(table.edgeSlots[symmetry][slot], edge, table.edgeFacelets[symmetry][slot][facelet]);
+    }
+
+    return conjugate;
+}
+
+CubeState Symmetry::canonicalize(const CubeState& state, int& symmetry) {
+    CubeState canonical(state);
+    StateRank canonicalRank(state);
+    symmetry = 0;
+
+    for (int candidate = 1; candidate < Symmetry::SYMMETRIES; candidate++) {
+        CubeState conjugate(Symmetry::conjugate(candidate, state));
+        StateRank rank(conjugate);
+
+        if (rank < canonicalRank) {
+            canonical = conjugate;
+            canonicalRank = rank;
+            symmetry = candidate;
+        }
+    }
+
+    return canonical;
+}
+
+}  // namespace Rubik
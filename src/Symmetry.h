@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <CubeState.h>
+
+namespace Rubik {
+
+// The 48 symmetries of the cube: 24 rotations (0 is the identity) followed by their mirror images.
+// Symmetries permute the faces and conjugate states, i.e. conjugate(s, state) is the state seen
+// after the whole cube and its colors are transformed by s.
+class Symmetry {
+public:
+    static const int SYMMETRIES = 48;
+    static const int ROTATIONS = 24;
+
+    static int find(Face up, Face right, Face front);
+
+    static Face getFace(int symmetry, Face face);
+    static bool isMirror(int symmetry);
+
+    static int multiply(int first, int second);
+    static int inverse(int symmetry);
+
+    static Move conjugate(int symmetry, Move move);
+    static CubeState conjugate(int symmetry, const CubeState& state);
+
+    static CubeState canonicalize(const CubeState& state, int& symmetry);
+};
+
+}  // namespace Rubik
+
+#endif  // SYMMETRY_H
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <TextureFile.h>
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+
+namespace Rubik {
+
+TextureFile::TextureFile(int width, int height):
+        width(width),
+        height(height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("TextureFile: invalid texture size");
+    }
+
+    this->levels.emplace_back(static_cast<size_t>(width) * height * BYTES_PER_PIXEL);
+}
+
+TextureFile TextureFile::fromTga(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<uint8_t> tga((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.is_open() || tga.size() < 18) {
+        throw std::runtime_error("TextureFile: failed to read " + filename);
+    }
+
+    int imageType = tga[2];
+    int width = tga[12] | (tga[13] << 8);
+    int height = tga[14] | (tga[15] << 8);
+    int pixelSize = tga[16] / 8;
+    bool topDown = (tga[17] & 0x20) != 0;
+
+    if (tga[1] != 0 || (imageType != 2 && imageType != 10) || (pixelSize != 3 && pixelSize != 4)) {
+        throw std::runtime_error("TextureFile: " + filename + " is not a 24/32 bit truecolor TGA");
+    }
+
+    TextureFile texture(width, height);
+    uint8_t* output = texture.getData();
+    size_t pixels = static_cast<size_t>(width) * height;
+    size_t offset = 18 + tga[0];
+
+    auto readPixel = [&tga, &offset, pixelSize, &filename](uint8_t* pixel) {
+        if (offset + pixelSize > tga.size()) {
+            throw std::runtime_error("TextureFile: " + filename + " is truncated");
+        }
+
+        // BGR(A) to RGBA
+        pixel[0] = tga[offset + 2];
+        pixel[1] = tga[offset + 1];
+        pixel[2] = tga[offset];
+        pixel[3] = (pixelSize == 4) ? tga[offset + 3] : 255;
+        offset += pixelSize;
+    };
+
+    for (size_t pixel = 0; pixel < pixels;) {
+        size_t count = 1;
+        bool repeat = false;
+
+        if (imageType == 10) {
+            if (offset >= tga.size()) {
+                throw std::runtime_error("TextureFile: " + filename + " is truncated");
+            }
+            repeat = (tga[offset] & 0x80) != 0;
+            count = std::min<size_t>((tga[offset++] & 0x7f) + 1, pixels - pixel);
+        }
+
+        for (size_t i = 0; i < count; i++, pixel++) {
+            if (repeat && i > 0) {
+                std::copy_n(output + (pixel - 1) * BYTES_PER_PIXEL, BYTES_PER_PIXEL, output + pixel * BYTES_PER_PIXEL);
+            } else {
+                readPixel(output + pixel * BYTES_PER_PIXEL);
+            }
+        }
+    }
+
+    if (topDown) {
+        size_t rowSize = static_cast<size_t>(width) * BYTES_PER_PIXEL;
+        for (int row = 0; row < height / 2; row++) {
+            std::swap_ranges(output + row * rowSize, output + (row + 1) * rowSize,
+                    output + (height - row - 1) * rowSize);
+        }
+    }
+
+    return texture;
+}
+
+int TextureFile::getLevelCount(int width, int height) {
+    int levels = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) {
+        levels++;
+    }
+
+    return levels;
+}
+
+void TextureFile::save(const std::string& filename) const {
+    Header header = {
+        MAGIC, VERSION, static_cast<uint32_t>(this->width), static_cast<uint32_t>(this->height),
+        static_cast<uint32_t>(this->levels.size()), 0
+    };
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto& level: this->levels) {
+        file.write(reinterpret_cast<const char*>(level.data()), level.size());
+    }
+
+    if (!file.flush()) {
+        throw std::runtime_error("TextureFile: failed to write " + filename);
+    }
+}
+
+// 2x2 box filter; odd dimensions reuse the last row or column
+void TextureFile::generateMipmaps() {
+    this->levels.resize(1);
+
+    for (int level = 1; level < TextureFile::getLevelCount(this->width, this->height); level++) {
+        int sourceWidth = this->getWidth(level - 1);
+        int sourceHeight = this->getHeight(level - 1);
+        int width = this->getWidth(level);
+        int height = this->getHeight(level);
+
+        this->levels.emplace_back(static_cast<size_t>(width) * height * BYTES_PER_PIXEL);
+        const uint8_t* source = this->getData(level - 1);
+        uint8_t* destination = this->getData(level);
+
+        for (int y = 0; y < height; y++) {
+            int y0 = std::min(y * 2, sourceHeight - 1);
+            int y1 = std::min(y * 2 + 1, sourceHeight - 1);
+
+            for (int x = 0; x < width; x++) {
+                int x0 = std::min(x * 2, sourceWidth - 1);
+                int x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+                for (int channel = 0; channel < BYTES_PER_PIXEL; channel++) {
+                    int sum = source[(y0 * sourceWidth + x0) * BYTES_PER_PIXEL + channel] +
+                              source[(y0 * sourceWidth + x1) * BYTES_PER_PIXEL + channel] +
+                              source[(y1 * sourceWidth + x0) * BYTES_PER_PIXEL + channel] +
+                              source[(y1 * sourceWidth + x1) * BYTES_PER_PIXEL + channel];
+                    destination[(y * width + x) * BYTES_PER_PIXEL + channel] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+int TextureFile::getWidth(int level) const {
+    return std::max(this->width >> level, 1);
+}
+
+int TextureFile::getHeight(int level) const {
+    return std::max(this->height >> level, 1);
+}
+
+int TextureFile::getLevels() const {
+    return static_cast<int>(this->levels.size());
+}
+
+uint8_t* TextureFile::getData(int level) {
+    return this->levels.at(level).data();
+}
+
+const uint8_t* TextureFile::getData(int level) const {
+    return this->levels.at(level).data();
+}
+
+}  // namespace Rubik
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TEXTUREFILE_H
+#define TEXTUREFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Rubik {
+
+// GPU-ready RGBA8 texture with its full mip chain, stored as a fixed header followed by the
+// levels in order, largest first. Rows are bottom to top as glTexImage2D expects them.
+class TextureFile {
+public:
+    static const uint32_t MAGIC = 0x58455452;  // "RTEX"
+    static const uint32_t VERSION = 1;
+    static const int BYTES_PER_PIXEL = 4;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levels;
+        uint32_t reserved;
+    };
+
+    TextureFile(int width, int height);
+
+    static TextureFile fromTga(const std::string& filename);
+    static int getLevelCount(int width, int height);
+
+    void save(const std::string& filename) const;
+    void generateMipmaps();
+
+    int getWidth(int level = 0) const;
+    int getHeight(int level = 0) const;
+    int getLevels() const;
+
+    uint8_t* getData(int level = 0);
+    const uint8_t* getData(int level = 0) const;
+
+private:
+    std::vector<std::vector<uint8_t>> levels;
+    int width;
+    int height;
+};
+
+}  // namespace Rubik
+
+#endif  // TEXTUREFILE_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+namespace Rubik {
+
+// Lock-free single producer, single consumer hand-off of the latest value. The writer fills its
+// own buffer and swaps it with the middle one, the reader swaps the middle one with its own when
+// it holds something newer. Neither side ever waits and intermediate values may be skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    T& getWriteBuffer() {
+        return this->buffers[this->back];
+    }
+
+    void publish() {
+        this->back = this->middle.exchange(this->back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    bool update() {
+        if ((this->middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+
+        this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& getReadBuffer() const {
+        return this->buffers[this->front];
+    }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;
+
+    T buffers[3] {};  // Value-initialized, the reader may look before anything is published
+    int front = 0;
+    int back = 2;
+    std::atomic<int> middle{1};
+};
+
+}  // namespace Rubik
+
+#endif  // TRIPLEBUFFER_H
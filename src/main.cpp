@@ -22,23 +22,64 @@
 
 #include <Rubik.h>
 #include <ArgumentParser.h>
+#include <Scrambler.h>
+#include <Session.h>
 #include <Config.h>
 #include <EngineConfig.h>
 
+#ifdef RUBIK_SERVER
+#include <Server.h>
+#include <csignal>
+#endif
+
+#include <iostream>
+#include <ctime>
+
+#ifdef RUBIK_SERVER
+static Rubik::Server* runningServer = nullptr;
+
+// run() returns once the listening socket is gone, which also unlinks the socket file
+static void StopServer(int /* signal */) {
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+#endif
+
 int main(int argc, char** argv) {
     Rubik::ArgumentParser arguments;
     arguments.setDescription(RUBIK_DESCRIPTION);
     arguments.setVersion(RUBIK_VERSION);
 
-    arguments.addArgument('f', "fov", "camera field of view", Rubik::ValueType::FLOAT);
-    arguments.addArgument('h', "height", "viewport height", Rubik::ValueType::INT);
-    arguments.addArgument('w', "width", "viewport width", Rubik::ValueType::INT);
-    arguments.addArgument('s', "samples", "MSAA samples", Rubik::ValueType::INT);
-    arguments.addArgument('F', "fps", "maximum fps limit", Rubik::ValueType::FLOAT);
-    arguments.addArgument('v', "vsync", "vertical sync", Rubik::ValueType::BOOL);
-    arguments.addArgument('d', "debug", "debug logging", Rubik::ValueType::BOOL);
-    arguments.addArgument('D', "data", "game data directory", Rubik::ValueType::STRING);
-    arguments.addArgument('S', "shuffles", "initial cube shuffles", Rubik::ValueType::INT);
+    // A rejected name would otherwise only show up as isSet() throwing later on
+    bool registered = arguments.addArgument('f', "fov", "camera field of view", Rubik::ValueType::FLOAT) &&
+            arguments.addArgument('h', "height", "viewport height", Rubik::ValueType::INT) &&
+            arguments.addArgument('w', "width", "viewport width", Rubik::ValueType::INT) &&
+            arguments.addArgument('s', "samples", "MSAA samples", Rubik::ValueType::INT) &&
+            arguments.addArgument('a', "fxaa", "FXAA post-process anti-aliasing", Rubik::ValueType::BOOL) &&
+            arguments.addArgument('F', "fps", "maximum fps limit", Rubik::ValueType::FLOAT) &&
+            arguments.addArgument('v', "vsync", "vertical sync", Rubik::ValueType::BOOL) &&
+            arguments.addArgument('d', "debug", "debug logging and per-frame allocation counts", Rubik::ValueType::BOOL) &&
+            arguments.addArgument('D', "data", "game data directory", Rubik::ValueType::STRING) &&
+            arguments.addArgument('S', "shuffles", "initial cube shuffles", Rubik::ValueType::INT) &&
+            arguments.addArgument('r', "scramble", "random-state cube scramble", Rubik::ValueType::BOOL) &&
+            arguments.addArgument('t', "training", "name the CFOP case and its algorithm", Rubik::ValueType::BOOL) &&
+            arguments.addArgument("scrambles", "print random-state scrambles and exit", Rubik::ValueType::INT) &&
+            arguments.addArgument("seed", "random seed", Rubik::ValueType::INT) &&
+            arguments.addArgument("renderer", "forward or deferred shading, picked by light count by default", Rubik::ValueType::STRING) &&
+            arguments.addArgument("shader-cache", "shader binary cache directory, empty to disable", Rubik::ValueType::STRING) &&
+            arguments.addArgument("solve-log", "solve statistics file, empty to disable", Rubik::ValueType::STRING) &&
+            arguments.addArgument("session", "saved game file, empty to disable", Rubik::ValueType::STRING);
+#ifdef RUBIK_SERVER
+    registered = registered &&
+            arguments.addArgument("serve", "run the solver daemon", Rubik::ValueType::BOOL) &&
+            arguments.addArgument("socket", "solver daemon socket path", Rubik::ValueType::STRING);
+#endif
+
+    if (!registered) {
+        std::cerr << "Failed to register command line options" << std::endl;
+        return EXIT_FAILURE;
+    }
 
     if (!arguments.parse(argc, argv)) {
         return EXIT_FAILURE;
@@ -48,6 +89,51 @@ int main(int argc, char** argv) {
         return EXIT_SUCCESS;
     }
 
+    // Both are declared INT, so the parser has already checked they fit an int
+    uint64_t seed = static_cast<uint64_t>(std::time(nullptr));
+    if (arguments.isSet("seed")) {
+        int seedValue = stoi(arguments.getOption("seed"));
+        if (seedValue < 0) {
+            std::cerr << "Invalid seed " << seedValue << ", must not be negative" << std::endl;
+            return EXIT_FAILURE;
+        }
+        seed = static_cast<uint64_t>(seedValue);
+    }
+
+    if (arguments.isSet("scrambles")) {
+        int scrambles = stoi(arguments.getOption("scrambles"));
+        if (scrambles <= 0) {
+            std::cerr << "Invalid scramble count " << scrambles << ", must be positive" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        Rubik::Scrambler scrambler(seed);
+        scrambler.write(std::cout, 0, static_cast<uint64_t>(scrambles));
+        return EXIT_SUCCESS;
+    }
+
+#ifdef RUBIK_SERVER
+    if (arguments.isSet("serve")) {
+        Rubik::Server server(arguments.isSet("socket") ? arguments.getOption("socket") : RUBIK_SOCKET);
+        runningServer = &server;
+        std::signal(SIGINT, StopServer);
+        std::signal(SIGTERM, StopServer);
+
+        int status = EXIT_SUCCESS;
+        try {
+            server.run();
+        } catch (const std::exception& exception) {
+            std::cerr << exception.what() << std::endl;
+            status = EXIT_FAILURE;
+        }
+
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        runningServer = nullptr;
+        return status;
+    }
+#endif
+
     auto& config = Graphene::GetEngineConfig();
     config.setFov(arguments.isSet("fov") ? stof(arguments.getOption("fov")) : 75.0f);
     config.setHeight(arguments.isSet("height") ? stoi(arguments.getOption("height")) : 480);
@@ -56,10 +142,50 @@ int main(int argc, char** argv) {
     config.setMaxFps(arguments.isSet("fps") ? stof(arguments.getOption("fps")) : 0.0f);
     config.setVsync(arguments.isSet("vsync"));
     config.setDebug(arguments.isSet("debug"));
-    config.setDataDirectory(arguments.isSet("data") ? arguments.getOption("data") : RUBIK_DATADIR);
+    std::string dataDirectory(arguments.isSet("data") ? arguments.getOption("data") : RUBIK_DATADIR);
+    config.setDataDirectory(dataDirectory);
+
+    // The driver reads its cache settings when the GL context is created
+    std::shared_ptr<Rubik::ShaderCache> shaderCache;
+    std::string shaderCacheDirectory(arguments.isSet("shader-cache") ?
+            arguments.getOption("shader-cache") : Rubik::ShaderCache::getDefaultDirectory());
+    if (!shaderCacheDirectory.empty()) {
+        shaderCache = std::make_shared<Rubik::ShaderCache>(dataDirectory + "/shaders", shaderCacheDirectory);
+        if (!shaderCache->enable()) {
+            std::cerr << "Failed to create shader cache " << shaderCache->getDirectory() << std::endl;
+            shaderCache.reset();
+        }
+    }
+
+    Rubik::RenderMode renderMode = Rubik::RenderMode::AUTO;
+    if (arguments.isSet("renderer")) {
+        std::string renderer(arguments.getOption("renderer"));
+        if (renderer == "forward") {
+            renderMode = Rubik::RenderMode::FORWARD;
+        } else if (renderer == "deferred") {
+            renderMode = Rubik::RenderMode::DEFERRED;
+        } else {
+            std::cerr << "Unknown renderer " << renderer << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
 
     Rubik::Rubik rubik;
+    rubik.setRenderMode(renderMode);
+    rubik.setFxaa(arguments.isSet("fxaa"));
+    rubik.setShaderCache(shaderCache);
     rubik.setShuffles(arguments.isSet("shuffles") ? stoi(arguments.getOption("shuffles")) : 20);
+    rubik.setRandomState(arguments.isSet("scramble"));
+    rubik.setTraining(arguments.isSet("training"));
+    rubik.setDebug(arguments.isSet("debug"));
+    rubik.setSeed(seed);
+
+    std::string solveLog(arguments.isSet("solve-log") ? arguments.getOption("solve-log") : Rubik::SolveLog::getDefaultPath());
+    if (!solveLog.empty() && !rubik.getSolveLog().open(solveLog)) {
+        std::cerr << "Failed to open solve log " << solveLog << std::endl;
+    }
+
+    rubik.setSessionPath(arguments.isSet("session") ? arguments.getOption("session") : Rubik::Session::getDefaultPath());
 
     return rubik.exec();
 }
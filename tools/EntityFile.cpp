@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <EntityFile.h>
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+namespace Rubik {
+
+namespace {
+
+template<typename T>
+void read(const std::vector<uint8_t>& data, size_t& offset, std::vector<T>& values, size_t count) {
+    if (offset + count * sizeof(T) > data.size()) {
+        throw std::runtime_error("EntityFile: truncated mesh");
+    }
+
+    values.resize(count);
+    std::memcpy(values.data(), data.data() + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+}
+
+template<typename T>
+void write(std::ofstream& file, const std::vector<T>& values) {
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+}  // namespace
+
+EntityFile EntityFile::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.is_open() || data.size() < MATERIAL_SIZE + 8) {
+        throw std::runtime_error("EntityFile: failed to read " + filename);
+    }
+
+    uint32_t magic, meshes;
+    std::memcpy(&magic, data.data(), sizeof(magic));
+    std::memcpy(&meshes, data.data() + 8, sizeof(meshes));
+    if (magic != MAGIC || meshes != 1) {
+        throw std::runtime_error("EntityFile: " + filename + " is not a single mesh entity");
+    }
+
+    int32_t counts[2];
+    std::memcpy(counts, data.data() + MATERIAL_SIZE, sizeof(counts));
+    if (counts[0] < 0 || counts[1] < 0) {
+        throw std::runtime_error("EntityFile: " + filename + " has an invalid mesh");
+    }
+
+    EntityFile entity;
+    entity.material.assign(data.begin(), data.begin() + MATERIAL_SIZE);
+
+    size_t offset = MATERIAL_SIZE + sizeof(counts);
+    read(data, offset, entity.positions, counts[0] * 3);
+    read(data, offset, entity.normals, counts[0] * 3);
+    read(data, offset, entity.textureCoordinates, counts[0] * 2);
+    read(data, offset, entity.faces, counts[1] * 3);
+
+    for (uint32_t vertex: entity.faces) {
+        if (vertex >= static_cast<uint32_t>(counts[0])) {
+            throw std::runtime_error("EntityFile: " + filename + " has an invalid mesh");
+        }
+    }
+
+    return entity;
+}
+
+void EntityFile::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("EntityFile: failed to open " + filename);
+    }
+
+    int32_t counts[2] = { static_cast<int32_t>(this->positions.size() / 3), static_cast<int32_t>(this->faces.size() / 3) };
+    file.write(reinterpret_cast<const char*>(this->material.data()), this->material.size());
+    file.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+
+    write(file, this->positions);
+    write(file, this->normals);
+    write(file, this->textureCoordinates);
+    write(file, this->faces);
+
+    if (!file.good()) {
+        throw std::runtime_error("EntityFile: failed to write " + filename);
+    }
+}
+
+int EntityFile::getFaceCount() const {
+    return static_cast<int>(this->faces.size() / 3);
+}
+
+std::array<float, 3> EntityFile::getFaceNormal(int face) const {
+    std::array<float, 3> normal = {{ 0.0f, 0.0f, 0.0f }};
+    for (int vertex = 0; vertex < 3; vertex++) {
+        for (int axis = 0; axis < 3; axis++) {
+            normal[axis] += this->normals[this->faces[face * 3 + vertex] * 3 + axis] / 3.0f;
+        }
+    }
+
+    return normal;
+}
+
+EntityFile EntityFile::select(const std::vector<bool>& faces) const {
+    EntityFile entity;
+    entity.material = this->material;
+
+    std::vector<int64_t> vertices(this->positions.size() / 3, -1);
+    for (size_t face = 0; face < faces.size(); face++) {
+        if (!faces[face]) {
+            continue;
+        }
+
+        for (int corner = 0; corner < 3; corner++) {
+            uint32_t vertex = this->faces[face * 3 + corner];
+            if (vertices[vertex] == -1) {
+                vertices[vertex] = static_cast<int64_t>(entity.positions.size() / 3);
+                entity.positions.insert(entity.positions.end(), &this->positions[vertex * 3], &this->positions[vertex * 3] + 3);
+                entity.normals.insert(entity.normals.end(), &this->normals[vertex * 3], &this->normals[vertex * 3] + 3);
+                entity.textureCoordinates.insert(entity.textureCoordinates.end(),
+                        &this->textureCoordinates[vertex * 2], &this->textureCoordinates[vertex * 2] + 2);
+            }
+
+            entity.faces.push_back(static_cast<uint32_t>(vertices[vertex]));
+        }
+    }
+
+    return entity;
+}
+
+}  // namespace Rubik
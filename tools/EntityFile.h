@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ENTITYFILE_H
+#define ENTITYFILE_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+namespace Rubik {
+
+// Single mesh Graphene entity: the header and material block, then the vertex and face counts,
+// positions, normals, texture coordinates and face indices. Only the mesh is ever changed, the
+// rest is carried over byte for byte.
+class EntityFile {
+public:
+    static const uint32_t MAGIC = 0x454E5047;  // "GPNE"
+    static const size_t MATERIAL_SIZE = 308;   // Header and material, up to the vertex count
+
+    static EntityFile load(const std::string& filename);
+    void save(const std::string& filename) const;
+
+    int getFaceCount() const;
+    std::array<float, 3> getFaceNormal(int face) const;
+
+    // Mesh of the selected faces only, unused vertices dropped
+    EntityFile select(const std::vector<bool>& faces) const;
+
+private:
+    std::vector<uint8_t> material;
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> textureCoordinates;
+    std::vector<uint32_t> faces;
+};
+
+}  // namespace Rubik
+
+#endif  // ENTITYFILE_H
@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Explorer.h>
+#include <StateRank.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Rubik {
+
+namespace {
+
+const size_t FRONTIER_CHUNK = 1 << 20;  // Ranks read from disk at once
+const size_t WORKER_BLOCK = 4096;       // Ranks taken by a worker at once
+const size_t OUTPUT_BUFFER = 1 << 16;   // Ranks buffered by a worker before writing
+
+std::runtime_error systemError(const std::string& message) {
+    return std::runtime_error(message + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+// Permutation or orientation of a fixed set of slots, with a move table over the subgroup moves
+class Explorer::Coordinate {
+public:
+    Coordinate(bool corners, bool orientation, const std::vector<int>& slots, const std::vector<Move>& moves):
+            corners(corners),
+            orientation(orientation),
+            slots(slots),
+            moveCount(static_cast<int>(moves.size())) {
+        int size = static_cast<int>(slots.size());
+        this->size = 1;
+
+        for (int i = 0; i < size - 1; i++) {
+            this->size *= orientation ? (corners ? 3 : 2) : (i + 2);
+        }
+
+        this->table.resize(this->size * this->moveCount);
+        for (uint64_t value = 0; value < this->size; value++) {
+            for (int move = 0; move < this->moveCount; move++) {
+                CubeState state;
+                this->set(state, value);
+                state.applyMove(moves[move]);
+                this->table[value * this->moveCount + move] = static_cast<uint32_t>(this->get(state));
+            }
+        }
+    }
+
+    uint64_t getSize() const {
+        return this->size;
+    }
+
+    uint64_t get(const CubeState& state) const {
+        int size = static_cast<int>(this->slots.size());
+        uint64_t value = 0;
+
+        if (this->orientation) {
+            for (int i = 0; i < size - 1; i++) {
+                value = value * (this->corners ? 3 : 2) + this->getOrientation(state, this->slots[i]);
+            }
+
+            return value;
+        }
+
+        int permutation[CubeState::EDGES];
+        for (int i = 0; i < size; i++) {
+            int piece = this->corners ? state.getCorner(this->slots[i]) : state.getEdge(this->slots[i]);
+            permutation[i] = static_cast<int>(std::find(this->slots.begin(), this->slots.end(), piece) - this->slots.begin());
+        }
+
+        return StateRank::rankPermutation(permutation, size);
+    }
+
+    uint64_t move(uint64_t value, int move) const {
+        return this->table[value * this->moveCount + move];
+    }
+
+private:
+    void set(CubeState& state, uint64_t value) const {
+        int size = static_cast<int>(this->slots.size());
+
+        if (this->orientation) {
+            int modulo = this->corners ? 3 : 2;
+            int total = 0;
+
+            for (int i = size - 2; i >= 0; i--) {
+                this->setSlot(state, this->slots[i], this->slots[i], static_cast<int>(value % modulo));
+                total += static_cast<int>(value % modulo);
+                value /= modulo;
+            }
+
+            this->setSlot(state, this->slots[size - 1], this->slots[size - 1], (modulo - total % modulo) % modulo);
+            return;
+        }
+
+        int permutation[CubeState::EDGES];
+        StateRank::unrankPermutation(value, permutation, size);
+
+        for (int i = 0; i < size; i++) {
+            this->setSlot(state, this->slots[i], this->slots[permutation[i]], 0);
+        }
+    }
+
+    int getOrientation(const CubeState& state, int slot) const {
+        return this->corners ? state.getCornerOrientation(slot) : state.getEdgeOrientation(slot);
+    }
+
+    void setSlot(CubeState& state, int slot, int piece, int orientation) const {
+        if (this->corners) {
+            state.setCorner(slot, piece, orientation);
+        } else {
+            state.setEdge(slot, piece, orientation);
+        }
+    }
+
+    bool corners;
+    bool orientation;
+    std::vector<int> slots;
+    int moveCount;
+
+    uint64_t size;
+    std::vector<uint32_t> table;
+};
+
+Explorer::Explorer(const std::string& subgroup, const std::string& directory):
+        subgroup(subgroup),
+        directory(directory),
+        threads(std::max(static_cast<int>(std::thread::hardware_concurrency()), 1)) {
+    if (subgroup == "corners") {
+        // Corners under all face turns, i.e. a 2x2x2 with a fixed reference
+        for (int move = 0; move < CubeState::MOVES; move++) {
+            this->moves.push_back(static_cast<Move>(move));
+        }
+
+        std::vector<int> corners = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        this->coordinates.emplace_back(true, false, corners, this->moves);
+        this->coordinates.emplace_back(true, true, corners, this->moves);
+    } else if (subgroup == "ur") {
+        // <U, R>: DLF and DBL corners and the D, L, F and B edges stay in place, edges never flip
+        this->moves = { Move::U, Move::U2, Move::U3, Move::R, Move::R2, Move::R3 };
+
+        std::vector<int> corners = { 0, 1, 2, 3, 4, 7 };
+        std::vector<int> edges = { 0, 1, 2, 3, 4, 8, 11 };
+        this->coordinates.emplace_back(true, false, corners, this->moves);
+        this->coordinates.emplace_back(true, true, corners, this->moves);
+        this->coordinates.emplace_back(false, false, edges, this->moves);
+    } else {
+        throw std::invalid_argument("Explorer(): unknown subgroup '" + subgroup + "'");
+    }
+}
+
+Explorer::~Explorer() {
+    if (this->visited != nullptr) {
+        munmap(this->visited, this->visitedSize);
+    }
+
+    if (this->visitedFile != -1) {
+        close(this->visitedFile);
+    }
+}
+
+int Explorer::getThreads() const {
+    return this->threads;
+}
+
+void Explorer::setThreads(int threads) {
+    this->threads = std::max(threads, 1);
+}
+
+std::vector<std::string> Explorer::getSubgroups() {
+    return { "corners", "ur" };
+}
+
+void Explorer::run() {
+    mkdir(this->directory.c_str(), 0755);
+
+    this->mapVisited();
+    this->loadCheckpoint();
+
+    if (this->depthCounts.empty()) {
+        std::fill(this->visited, this->visited + this->visitedSize / sizeof(uint64_t), 0);
+
+        uint64_t solved = this->rank(CubeState());
+        this->discover(solved);
+
+        std::ofstream frontier(this->getFrontierPath(0), std::ios::binary);
+        frontier.write(reinterpret_cast<const char*>(&solved), sizeof(solved));
+        frontier.close();
+
+        this->depthCounts.push_back(1);
+        this->saveCheckpoint();
+    } else {
+        std::cout << "Resuming " << this->subgroup << " at depth " << this->depthCounts.size() - 1 << "\n";
+
+        // Discoveries past the last checkpoint belong to an unfinished frontier
+        std::remove(this->getFrontierPath(static_cast<int>(this->depthCounts.size())).c_str());
+    }
+
+    if (this->depthCounts.back() > 0) {
+        this->commitFrontier(static_cast<int>(this->depthCounts.size()) - 1);
+        this->discardDiscovered();
+    }
+
+    std::cout << "Exploring " << this->subgroup << ", " << this->getSize() << " ranks, "
+              << this->threads << " threads\n" << std::flush;
+
+    while (this->depthCounts.back() > 0) {
+        int depth = static_cast<int>(this->depthCounts.size()) - 1;
+        this->bytesRead = 0;
+        this->bytesWritten = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        this->expandFrontier(depth);
+        this->saveCheckpoint();
+        this->commitFrontier(depth + 1);
+        std::remove(this->getFrontierPath(depth).c_str());
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double seconds = std::max(elapsed.count(), 1e-9);
+        std::cout << "depth " << std::setw(2) << depth + 1 << ": " << std::setw(12) << this->depthCounts.back() << " states, "
+                  << std::fixed << std::setprecision(1) << elapsed.count() << " s, "
+                  << std::setprecision(0) << this->depthCounts[depth] * this->moves.size() / seconds << " nodes/s, "
+                  << this->depthCounts.back() / seconds << " states/s, "
+                  << std::setprecision(1) << this->bytesRead / seconds / 1e6 << " MB/s read, "
+                  << this->bytesWritten / seconds / 1e6 << " MB/s written\n" << std::defaultfloat << std::flush;
+    }
+
+    std::remove(this->getFrontierPath(static_cast<int>(this->depthCounts.size()) - 1).c_str());
+
+    uint64_t total = 0;
+    for (uint64_t count: this->depthCounts) {
+        total += count;
+    }
+
+    std::cout << "Total " << total << " states, diameter " << this->depthCounts.size() - 2 << "\n";
+}
+
+uint64_t Explorer::getSize() const {
+    uint64_t size = 1;
+    for (auto& coordinate: this->coordinates) {
+        size *= coordinate.getSize();
+    }
+
+    return size;
+}
+
+uint64_t Explorer::rank(const CubeState& state) const {
+    uint64_t rank = 0;
+    for (auto& coordinate: this->coordinates) {
+        rank = rank * coordinate.getSize() + coordinate.get(state);
+    }
+
+    return rank;
+}
+
+uint64_t Explorer::applyMove(uint64_t rank, int move) const {
+    uint64_t result = 0;
+    uint64_t scale = 1;
+
+    for (auto coordinate = this->coordinates.rbegin(); coordinate != this->coordinates.rend(); coordinate++) {
+        uint64_t size = coordinate->getSize();
+        result += coordinate->move(rank % size, move) * scale;
+        rank /= size;
+        scale *= size;
+    }
+
+    return result;
+}
+
+bool Explorer::discover(uint64_t rank) {
+    std::atomic<uint64_t>& word = this->visited[rank / 32];
+    int shift = static_cast<int>(rank % 32) * 2;
+    uint64_t value = word.load(std::memory_order_relaxed);
+
+    do {
+        if (((value >> shift) & 3) != UNSEEN) {
+            return false;
+        }
+    } while (!word.compare_exchange_weak(value, value | (static_cast<uint64_t>(DISCOVERED) << shift), std::memory_order_relaxed));
+
+    return true;
+}
+
+void Explorer::commitFrontier(int depth) {
+    std::FILE* frontier = std::fopen(this->getFrontierPath(depth).c_str(), "rb");
+    if (frontier == nullptr) {
+        throw systemError("commitFrontier(): cannot open frontier");
+    }
+
+    std::vector<uint64_t> chunk(FRONTIER_CHUNK);
+    size_t count;
+
+    while ((count = std::fread(chunk.data(), sizeof(uint64_t), chunk.size(), frontier)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            std::atomic<uint64_t>& word = this->visited[chunk[i] / 32];
+            int shift = static_cast<int>(chunk[i] % 32) * 2;
+            uint64_t value = word.load(std::memory_order_relaxed);
+            word.store((value & ~(3ull << shift)) | (static_cast<uint64_t>(SEEN) << shift), std::memory_order_relaxed);
+        }
+    }
+
+    std::fclose(frontier);
+    msync(this->visited, this->visitedSize, MS_SYNC);
+}
+
+void Explorer::discardDiscovered() {
+    const uint64_t highBits = 0xAAAAAAAAAAAAAAAAull;
+    const uint64_t lowBits = 0x5555555555555555ull;
+
+    for (size_t i = 0; i < this->visitedSize / sizeof(uint64_t); i++) {
+        uint64_t value = this->visited[i].load(std::memory_order_relaxed);
+        uint64_t discovered = value & highBits & ~((value & lowBits) << 1);
+
+        if (discovered != 0) {
+            this->visited[i].store(value & ~discovered, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Explorer::expandFrontier(int depth) {
+    std::FILE* input = std::fopen(this->getFrontierPath(depth).c_str(), "rb");
+    if (input == nullptr) {
+        throw systemError("expandFrontier(): cannot open frontier");
+    }
+
+    std::FILE* output = std::fopen(this->getFrontierPath(depth + 1).c_str(), "wb");
+    if (output == nullptr) {
+        std::fclose(input);
+        throw systemError("expandFrontier(): cannot create frontier");
+    }
+
+    std::vector<uint64_t> chunk(FRONTIER_CHUNK);
+    std::mutex outputMutex;
+    uint64_t discovered = 0;
+    bool writeFailed = false;
+    size_t count;
+
+    while ((count = std::fread(chunk.data(), sizeof(uint64_t), chunk.size(), input)) > 0) {
+        this->bytesRead += count * sizeof(uint64_t);
+        std::atomic<size_t> nextBlock(0);
+
+        auto worker = [&]() {
+            std::vector<uint64_t> buffer;
+            buffer.reserve(OUTPUT_BUFFER + this->moves.size());
+
+            auto flush = [&]() {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                writeFailed |= (std::fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), output) != buffer.size());
+                this->bytesWritten += buffer.size() * sizeof(uint64_t);
+                discovered += buffer.size();
+                buffer.clear();
+            };
+
+            for (size_t block = nextBlock.fetch_add(WORKER_BLOCK); block < count; block = nextBlock.fetch_add(WORKER_BLOCK)) {
+                for (size_t i = block; i < std::min(block + WORKER_BLOCK, count); i++) {
+                    for (size_t move = 0; move < this->moves.size(); move++) {
+                        uint64_t rank = this->applyMove(chunk[i], static_cast<int>(move));
+                        if (this->discover(rank)) {
+                            buffer.push_back(rank);
+                        }
+                    }
+                }
+
+                if (buffer.size() >= OUTPUT_BUFFER) {
+                    flush();
+                }
+            }
+
+            flush();
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < this->threads; i++) {
+            workers.emplace_back(worker);
+        }
+
+        worker();
+        for (auto& thread: workers) {
+            thread.join();
+        }
+    }
+
+    std::fclose(input);
+    writeFailed |= (std::fflush(output) != 0 || fsync(fileno(output)) != 0);
+    std::fclose(output);
+
+    if (writeFailed) {
+        throw systemError("expandFrontier(): cannot write frontier");
+    }
+
+    this->depthCounts.push_back(discovered);
+}
+
+void Explorer::mapVisited() {
+    std::string path(this->directory + "/visited");
+    this->visitedSize = (this->getSize() + 31) / 32 * sizeof(uint64_t);
+
+    this->visitedFile = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (this->visitedFile == -1 || ftruncate(this->visitedFile, static_cast<off_t>(this->visitedSize)) != 0) {
+        throw systemError("mapVisited(): cannot create " + path);
+    }
+
+    void* visited = mmap(nullptr, this->visitedSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->visitedFile, 0);
+    if (visited == MAP_FAILED) {
+        throw systemError("mapVisited(): cannot map " + path);
+    }
+
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Visited words must map onto the file");
+    this->visited = static_cast<std::atomic<uint64_t>*>(visited);
+}
+
+void Explorer::loadCheckpoint() {
+    std::ifstream checkpoint(this->directory + "/checkpoint");
+    if (!checkpoint) {
+        return;
+    }
+
+    std::string subgroup;
+    checkpoint >> subgroup;
+
+    if (subgroup != this->subgroup) {
+        throw std::runtime_error("loadCheckpoint(): directory holds '" + subgroup + "' subgroup");
+    }
+
+    uint64_t count;
+    while (checkpoint >> count) {
+        this->depthCounts.push_back(count);
+    }
+}
+
+void Explorer::saveCheckpoint() const {
+    std::string path(this->directory + "/checkpoint");
+
+    std::ofstream checkpoint(path + ".tmp", std::ios::trunc);
+    checkpoint << this->subgroup << "\n";
+
+    for (uint64_t count: this->depthCounts) {
+        checkpoint << count << "\n";
+    }
+
+    checkpoint.close();
+    if (!checkpoint || std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+        throw systemError("saveCheckpoint(): cannot write " + path);
+    }
+}
+
+std::string Explorer::getFrontierPath(int depth) const {
+    std::stringstream path;
+    path << this->directory << "/frontier-" << std::setw(2) << std::setfill('0') << depth;
+    return path.str();
+}
+
+}  // namespace Rubik
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EXPLORER_H
+#define EXPLORER_H
+
+#include <CubeState.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+
+namespace Rubik {
+
+// Frontier by frontier breadth-first search over the ranked states of a subgroup. Visited
+// states live in a memory mapped array of 2-bit entries, frontiers are streamed to and from
+// disk sequentially. Every finished depth is checkpointed, an interrupted run picks up
+// from the last complete frontier.
+class Explorer {
+public:
+    Explorer(const std::string& subgroup, const std::string& directory);
+    ~Explorer();
+
+    int getThreads() const;
+    void setThreads(int threads);
+
+    static std::vector<std::string> getSubgroups();
+
+    void run();
+
+private:
+    class Coordinate;
+
+    enum VisitedState { UNSEEN = 0, SEEN = 1, DISCOVERED = 2 };
+
+    uint64_t getSize() const;
+    uint64_t rank(const CubeState& state) const;
+    uint64_t applyMove(uint64_t rank, int move) const;
+
+    bool discover(uint64_t rank);
+    void commitFrontier(int depth);
+    void discardDiscovered();
+    void expandFrontier(int depth);
+
+    void mapVisited();
+    void loadCheckpoint();
+    void saveCheckpoint() const;
+    std::string getFrontierPath(int depth) const;
+
+    std::string subgroup;
+    std::string directory;
+    std::vector<Coordinate> coordinates;
+    std::vector<Move> moves;
+
+    std::atomic<uint64_t>* visited = nullptr;
+    size_t visitedSize = 0;
+    int visitedFile = -1;
+
+    std::vector<uint64_t> depthCounts;
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    int threads;
+};
+
+}  // namespace Rubik
+
+#endif  // EXPLORER_H
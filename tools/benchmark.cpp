@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Puzzle.h>
+#include <Notation.h>
+#include <Symmetry.h>
+#include <Random.h>
+#include <ArgumentParser.h>
+#include <Config.h>
+#include <functional>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+namespace Rubik {
+
+// Puzzle internals are timed directly, the benchmark is a friend of Puzzle
+class PuzzleBenchmark {
+public:
+    PuzzleBenchmark(double minTime, unsigned int seed):
+            minTime(minTime),
+            seed(seed) {
+    }
+
+    int run() {
+        this->benchmarks();
+        this->properties();
+        return (this->failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+private:
+    static void attach(Puzzle& puzzle) {
+        for (int cube = 0; cube < Puzzle::CUBES; cube++) {
+            puzzle.addCube(cube + 1);  // Object ids start at 1, 0 is the empty pickup buffer
+        }
+    }
+
+    static AnimationState randomTurn() {
+        return static_cast<AnimationState>(std::rand() % 4 + 1);
+    }
+
+    static AnimationState inverseTurn(AnimationState state) {
+        switch (state) {
+            case AnimationState::LEFT_ROTATION:
+                return AnimationState::RIGHT_ROTATION;
+
+            case AnimationState::RIGHT_ROTATION:
+                return AnimationState::LEFT_ROTATION;
+
+            case AnimationState::UP_ROTATION:
+                return AnimationState::DOWN_ROTATION;
+
+            case AnimationState::DOWN_ROTATION:
+                return AnimationState::UP_ROTATION;
+
+            default:
+                return AnimationState::IDLE;
+        }
+    }
+
+    // Same cubies in the same places and orientations, quaternions are equal up to sign
+    static bool equal(const Puzzle& first, const Puzzle& second) {
+        if (first.getState() != second.getState()) {
+            return false;
+        }
+
+        for (int cube = 0; cube < Puzzle::CUBES; cube++) {
+            if (first.getCubePosition(first.getCubeId(cube)) != second.getCubePosition(second.getCubeId(cube))) {
+                return false;
+            }
+
+            const Quaternion& a = first.getCubeRotation(cube);
+            const Quaternion& b = second.getCubeRotation(cube);
+            float dot = a.getW() * b.getW() + a.getX() * b.getX() + a.getY() * b.getY() + a.getZ() * b.getZ();
+            if (std::fabs(std::fabs(dot) - 1.0f) > 1e-3f) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static void copy(const Puzzle& source, Puzzle& target) {
+        std::copy_n(&source.cubes[0][0][0], Puzzle::CUBES, &target.cubes[0][0][0]);
+        std::copy_n(source.cells, Puzzle::CUBES, target.cells);
+        std::copy_n(source.rotations, Puzzle::CUBES, target.rotations);
+        target.cubeState = source.cubeState;
+        target.frame = source.frame;
+    }
+
+    // Throughput is reported as well when every operation handles a known number of bytes
+    void measure(const std::string& name, const std::function<void(int)>& operation, size_t bytes = 0) {
+        using Clock = std::chrono::steady_clock;
+        long iterations = 1;
+        double elapsed = 0.0;
+
+        // Grow the batch until it runs long enough for the clock to be meaningful
+        while (true) {
+            Clock::time_point start = Clock::now();
+            for (long i = 0; i < iterations; i++) {
+                operation(static_cast<int>(i));
+            }
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+            if (elapsed >= this->minTime) {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "{\"benchmark\": \"" << name << "\", \"iterations\": " << iterations
+                  << ", \"ns_per_op\": " << elapsed * 1e9 / iterations;
+        if (bytes > 0) {
+            std::cout << ", \"mb_per_s\": " << bytes * iterations / elapsed / 1e6;
+        }
+        std::cout << "}\n";
+    }
+
+    void check(const std::string& name, int cases, const std::function<bool(int)>& property) {
+        int failures = 0;
+        for (int i = 0; i < cases; i++) {
+            if (!property(i)) {
+                failures++;
+            }
+        }
+
+        std::cout << "{\"property\": \"" << name << "\", \"cases\": " << cases
+                  << ", \"failures\": " << failures << "}\n";
+        this->failures += failures;
+    }
+
+    void benchmarks() {
+        std::srand(this->seed);
+        Puzzle puzzle;
+        PuzzleBenchmark::attach(puzzle);
+        volatile int sink = 0;
+
+        this->measure("rotateFacet", [&puzzle](int i) {
+            puzzle.rotateFacet(i % 3, (i / 3) % 3, static_cast<AnimationState>(i % 4 + 1));
+        });
+
+        this->measure("rotateEntities", [&puzzle](int i) {
+            puzzle.rotateEntities(i % 3, (i / 3) % 3, 2.5f, static_cast<AnimationState>(i % 4 + 1));
+        });
+
+        this->measure("getCubePosition", [&puzzle, &sink](int i) {
+            sink = sink + std::get<2>(puzzle.getCubePosition(i % Puzzle::CUBES + 1));
+        });
+
+        this->measure("getCubeCell", [&puzzle, &sink](int i) {
+            sink = sink + puzzle.getCubeCell(i % Puzzle::CUBES);
+        });
+
+        this->measure("isSolved", [&puzzle, &sink](int) {
+            sink = sink + puzzle.isSolved();
+        });
+
+        this->measure("shuffle", [&puzzle](int) {
+            puzzle.shuffle(1);
+        });
+
+        // One 120 Hz tick of an animated turn, a new turn starts whenever the last one completes
+        this->measure("update", [&puzzle](int i) {
+            if (puzzle.getAnimationState() == AnimationState::IDLE) {
+                puzzle.selectCube(i % Puzzle::CUBES + 1);
+                puzzle.setAnimationState(static_cast<AnimationState>(i % 4 + 1));
+            }
+            puzzle.update(1.0f / 120.0f);
+        });
+
+        this->notationBenchmarks();
+    }
+
+    static std::string formatMoves(const std::vector<Move>& moves) {
+        std::string text(moves.size() * Notation::MOVE_LENGTH, ' ');
+        text.resize(Notation::formatMoves(moves.data(), moves.size(), &text[0], text.size()));
+        return text;
+    }
+
+    static std::string formatFacelets(const CubeState& state) {
+        std::string text(Notation::FACELETS, ' ');
+        Notation::formatFacelets(state, &text[0]);
+        return text;
+    }
+
+    static std::vector<Move> randomMoves(Random& random, int count) {
+        std::vector<Move> moves;
+        for (int i = 0; i < count; i++) {
+            moves.push_back(static_cast<Move>(random.uniform(CubeState::MOVES)));
+        }
+
+        return moves;
+    }
+
+    // Corpora of scrambles and facelet strings, parsed a line at a time as if mmap'd
+    void notationBenchmarks() {
+        Random random(this->seed, 0);
+        std::string scrambles;
+        std::string states;
+        for (int i = 0; i < 1000; i++) {
+            scrambles += PuzzleBenchmark::formatMoves(PuzzleBenchmark::randomMoves(random, 25)) + "\n";
+            states += PuzzleBenchmark::formatFacelets(CubeState::random(random)) + "\n";
+        }
+
+        volatile size_t sink = 0;
+        Move moves[64];
+
+        this->measure("parseMoves", [&scrambles, &sink, &moves](int) {
+            std::string_view text(scrambles);
+            while (!text.empty()) {
+                sink = sink + Notation::parseMoves(Notation::nextLine(text), moves, 64).moves;
+            }
+        }, scrambles.size());
+
+        this->measure("parseFacelets", [&states, &sink](int) {
+            std::string_view text(states);
+            CubeState state;
+            while (!text.empty()) {
+                sink = sink + static_cast<size_t>(Notation::parseFacelets(Notation::nextLine(text), state));
+            }
+        }, states.size());
+
+        std::vector<Move> scramble(PuzzleBenchmark::randomMoves(random, 25));
+        char buffer[25 * Notation::MOVE_LENGTH];
+        this->measure("formatMoves", [&scramble, &buffer, &sink](int) {
+            sink = sink + Notation::formatMoves(scramble.data(), scramble.size(), buffer, sizeof(buffer));
+        }, PuzzleBenchmark::formatMoves(scramble).size());
+
+        CubeState state(CubeState::random(random));
+        this->measure("formatFacelets", [&state, &buffer](int) {
+            Notation::formatFacelets(state, buffer);
+        }, Notation::FACELETS);
+    }
+
+    void properties() {
+        std::srand(this->seed);
+        Puzzle puzzle;
+        Puzzle reference;
+        PuzzleBenchmark::attach(puzzle);
+        PuzzleBenchmark::attach(reference);
+
+        this->check("four identical turns are the identity", 1000, [&puzzle, &reference](int) {
+            puzzle.shuffle(20);
+            PuzzleBenchmark::copy(puzzle, reference);
+
+            int objectId = std::rand() % Puzzle::CUBES + 1;
+            AnimationState state = PuzzleBenchmark::randomTurn();
+            for (int i = 0; i < 4; i++) {
+                puzzle.turn(objectId, state);
+            }
+
+            return PuzzleBenchmark::equal(puzzle, reference);
+        });
+
+        this->check("a turn followed by its inverse is the identity", 1000, [&puzzle, &reference](int) {
+            puzzle.shuffle(20);
+            PuzzleBenchmark::copy(puzzle, reference);
+
+            int objectId = (std::rand() % 4 == 0) ? -1 : std::rand() % Puzzle::CUBES + 1;
+            AnimationState state = PuzzleBenchmark::randomTurn();
+            puzzle.turn(objectId, state);
+            puzzle.turn(objectId, PuzzleBenchmark::inverseTurn(state));
+
+            return PuzzleBenchmark::equal(puzzle, reference);
+        });
+
+        this->check("animated turns match instant turns", 200, [&puzzle, &reference](int) {
+            puzzle.shuffle(20);
+            PuzzleBenchmark::copy(puzzle, reference);
+
+            int objectId = std::rand() % Puzzle::CUBES + 1;
+            AnimationState state = PuzzleBenchmark::randomTurn();
+            reference.turn(objectId, state);
+
+            puzzle.selectCube(objectId);
+            puzzle.setAnimationState(state);
+            while (puzzle.getAnimationState() != AnimationState::IDLE) {
+                puzzle.update(1.0f / 120.0f);
+            }
+
+            return PuzzleBenchmark::equal(puzzle, reference);
+        });
+
+        this->check("whole cube rotations keep the cube solved", 1000, [](int) {
+            Puzzle solved;
+            PuzzleBenchmark::attach(solved);
+
+            int rotations = std::rand() % 8 + 1;
+            for (int i = 0; i < rotations; i++) {
+                solved.turn(-1, PuzzleBenchmark::randomTurn());
+            }
+
+            return solved.isSolved();
+        });
+
+        this->check("a single layer turn unsolves the cube", 1000, [](int) {
+            Puzzle solved;
+            PuzzleBenchmark::attach(solved);
+            solved.turn(std::rand() % Puzzle::CUBES + 1, PuzzleBenchmark::randomTurn());
+            return !solved.isSolved();
+        });
+
+        this->notationProperties();
+        this->symmetryProperties();
+    }
+
+    void notationProperties() {
+        Random random(this->seed, 1);
+
+        this->check("formatted moves parse back", 1000, [&random](int) {
+            std::vector<Move> moves(PuzzleBenchmark::randomMoves(random, 25));
+            std::string text(PuzzleBenchmark::formatMoves(moves));
+
+            Move parsed[25];
+            Notation::Result result = Notation::parseMoves(text, parsed, 25);
+            return (result.error == NotationError::NONE && std::vector<Move>(parsed, parsed + result.moves) == moves);
+        });
+
+        this->check("formatted facelets parse back", 1000, [&random](int) {
+            CubeState state(CubeState::random(random));
+            CubeState parsed;
+            return (Notation::parseFacelets(PuzzleBenchmark::formatFacelets(state), parsed) == NotationError::NONE && parsed == state);
+        });
+
+        // Wide, slice and whole cube turns track the cube orientation, undoing them has to match up
+        this->check("moves followed by their inverse are the identity", 1000, [&random](int) {
+            static const char* names[] = { "U", "R", "F", "D", "L", "B", "u", "Rw", "f", "d", "l", "b", "M", "E", "S", "x", "y", "z" };
+            static const char* turns[] = { "", "2", "'" };
+            static const char* inverseTurns[] = { "'", "2'", "" };
+
+            std::string text;
+            std::string inverse;
+            for (int i = 0; i < 20; i++) {
+                std::string name(names[random.uniform(18)]);
+                int turn = random.uniform(3);
+                text += name + turns[turn] + " ";
+                inverse = name + inverseTurns[turn] + " " + inverse;
+            }
+
+            Move moves[80];
+            Notation::Result result = Notation::parseMoves(text + inverse, moves, 80);
+
+            CubeState state;
+            state.applyMoves(std::vector<Move>(moves, moves + result.moves));
+            return (result.error == NotationError::NONE && state.isSolved());
+        });
+
+        // A corner twisted in place, an edge flipped in place and two edges swapped
+        this->check("illegal facelets are rejected", 1000, [&random](int) {
+            std::string text(PuzzleBenchmark::formatFacelets(CubeState::random(random)));
+            CubeState state;
+
+            std::string twisted(text);
+            std::swap(twisted[8], twisted[9]);
+            std::swap(twisted[9], twisted[20]);
+
+            std::string flipped(text);
+            std::swap(flipped[5], flipped[10]);
+
+            std::string swapped(text);
+            std::swap(swapped[5], swapped[7]);
+            std::swap(swapped[10], swapped[19]);
+
+            return (Notation::parseFacelets(twisted, state) == NotationError::TWIST &&
+                    Notation::parseFacelets(flipped, state) == NotationError::FLIP &&
+                    Notation::parseFacelets(swapped, state) == NotationError::PARITY);
+        });
+    }
+
+    void symmetryProperties() {
+        Random random(this->seed, 2);
+
+        // Mirrors included, conjugating a state and its turns has to commute with applying them
+        this->check("conjugated moves act on conjugated states", Symmetry::SYMMETRIES, [&random](int symmetry) {
+            CubeState state(CubeState::random(random));
+            CubeState conjugate(Symmetry::conjugate(symmetry, state));
+
+            for (int move = 0; move < CubeState::MOVES; move++) {
+                CubeState turned(state);
+                turned.applyMove(static_cast<Move>(move));
+
+                CubeState expected(conjugate);
+                expected.applyMove(Symmetry::conjugate(symmetry, static_cast<Move>(move)));
+                if (Symmetry::conjugate(symmetry, turned) != expected) {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+        // The puzzle is rolled into every orientation with whole cube turns, a face turned where
+        // it sits has to be the move conjugated back by that orientation
+        this->check("conjugated moves match turns of the rotated puzzle", Symmetry::ROTATIONS, [&random](int rotation) {
+            Puzzle puzzle;
+            PuzzleBenchmark::attach(puzzle);
+            puzzle.shuffle(20);
+            while (puzzle.getFrame() != rotation) {
+                puzzle.turn(-1, PuzzleBenchmark::randomTurn());
+            }
+
+            for (int face = 0; face < 6; face++) {
+                CubeState expected(puzzle.getState());
+                expected.applyMove(Symmetry::conjugate(Symmetry::inverse(rotation), static_cast<Move>(face * 3)));
+
+                CubeState seen(Symmetry::conjugate(rotation, puzzle.getState()));
+                seen.applyMove(static_cast<Move>(face * 3));
+
+                puzzle.turnFace(static_cast<Face>(face));
+                if (puzzle.getState() != expected || Symmetry::conjugate(rotation, puzzle.getState()) != seen) {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+        this->check("symmetric states share a canonical state", 200, [&random](int) {
+            CubeState state(CubeState::random(random));
+            int symmetry = 0;
+            CubeState canonical(Symmetry::canonicalize(state, symmetry));
+            if (Symmetry::conjugate(symmetry, state) != canonical) {
+                return false;
+            }
+
+            for (int conjugate = 0; conjugate < Symmetry::SYMMETRIES; conjugate++) {
+                int other = 0;
+                if (Symmetry::canonicalize(Symmetry::conjugate(conjugate, state), other) != canonical) {
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    double minTime;
+    unsigned int seed;
+    int failures = 0;
+};
+
+}  // namespace Rubik
+
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("Puzzle microbenchmarks and property checks, one JSON object per line");
+    arguments.setVersion(RUBIK_VERSION);
+
+    arguments.addArgument('t', "time", "minimum seconds per benchmark", Rubik::ValueType::FLOAT);
+    arguments.addArgument("seed", "random seed", Rubik::ValueType::INT);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    Rubik::PuzzleBenchmark benchmark(arguments.isSet("time") ? stod(arguments.getOption("time")) : 0.2,
+            arguments.isSet("seed") ? stoul(arguments.getOption("seed")) : 1);
+    return benchmark.run();
+}
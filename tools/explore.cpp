@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Explorer.h>
+#include <ArgumentParser.h>
+#include <Config.h>
+#include <iostream>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("Breadth-first distance distribution of a cube subgroup");
+    arguments.setVersion(RUBIK_VERSION);
+
+    std::string subgroups;
+    for (auto& subgroup: Rubik::Explorer::getSubgroups()) {
+        subgroups += (subgroups.empty() ? "" : ", ") + subgroup;
+    }
+
+    arguments.addArgument('g', "subgroup", "subgroup to explore (" + subgroups + ")", Rubik::ValueType::STRING);
+    arguments.addArgument('o', "output", "working directory, resumed if present", Rubik::ValueType::STRING);
+    arguments.addArgument('t', "threads", "worker threads", Rubik::ValueType::INT);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    try {
+        std::string subgroup(arguments.isSet("subgroup") ? arguments.getOption("subgroup") : "corners");
+        Rubik::Explorer explorer(subgroup, arguments.isSet("output") ? arguments.getOption("output") : subgroup);
+
+        if (arguments.isSet("threads")) {
+            explorer.setThreads(stoi(arguments.getOption("threads")));
+        }
+
+        explorer.run();
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <EntityFile.h>
+#include <ArgumentParser.h>
+#include <Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+namespace {
+
+const float SIDE_THRESHOLD = 0.3f;  // Bevels lean towards each side they join
+
+// Sides of the cubie a face belongs to, bit 2 * axis for the negative side and 2 * axis + 1
+// for the positive one
+int GetFaceSides(const Rubik::EntityFile& entity, int face) {
+    std::array<float, 3> normal(entity.getFaceNormal(face));
+    int sides = 0;
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (normal[axis] < -SIDE_THRESHOLD) {
+            sides |= 1 << (axis * 2);
+        } else if (normal[axis] > SIDE_THRESHOLD) {
+            sides |= 1 << (axis * 2 + 1);
+        }
+    }
+
+    return sides;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("Splits the cubie mesh into outer and inner meshes for every grid position");
+    arguments.setVersion(RUBIK_VERSION);
+
+    arguments.addArgument('i', "input", "cubie entity", Rubik::ValueType::STRING);
+    arguments.addArgument('o', "output", "output prefix, '-ijk.entity' and '-ijk-inner.entity' are appended", Rubik::ValueType::STRING);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    if (!arguments.isSet("input") || !arguments.isSet("output")) {
+        std::cerr << "Both --input and --output are required\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Rubik::EntityFile entity(Rubik::EntityFile::load(arguments.getOption("input")));
+        std::vector<int> faceSides;
+        for (int face = 0; face < entity.getFaceCount(); face++) {
+            faceSides.push_back(GetFaceSides(entity, face));
+        }
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                for (int k = 0; k < 3; k++) {
+                    // Sides facing out of the puzzle, the core has none and needs no mesh at all
+                    int outerSides = 0;
+                    int position[] = { i, j, k };
+                    for (int axis = 0; axis < 3; axis++) {
+                        if (position[axis] != 1) {
+                            outerSides |= 1 << (axis * 2 + position[axis] / 2);
+                        }
+                    }
+
+                    if (outerSides == 0) {
+                        continue;
+                    }
+
+                    std::vector<bool> outerFaces;
+                    std::vector<bool> innerFaces;
+                    for (int sides: faceSides) {
+                        outerFaces.push_back((sides & outerSides) != 0);
+                        innerFaces.push_back((sides & outerSides) == 0);
+                    }
+
+                    std::stringstream name;
+                    name << arguments.getOption("output") << "-" << i << j << k;
+                    entity.select(outerFaces).save(name.str() + ".entity");
+                    entity.select(innerFaces).save(name.str() + "-inner.entity");
+                }
+            }
+        }
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <BidirectionalSolver.h>
+#include <Solver.h>
+#include <ArgumentParser.h>
+#include <Random.h>
+#include <Config.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+
+// Solves random scrambles of a given length optimally with the bidirectional solver, printing one
+// JSON object per solve next to the two-phase solver's length. Every solution is checked to solve
+// the cube within the scramble length, the exit status tells whether all of them did.
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("Bidirectional optimal solver benchmark");
+    arguments.setVersion(RUBIK_VERSION);
+
+    arguments.addArgument('d', "depth", "scramble length, 10 by default", Rubik::ValueType::INT);
+    arguments.addArgument('c', "count", "scrambles to solve", Rubik::ValueType::INT);
+    arguments.addArgument('t', "threads", "solver threads", Rubik::ValueType::INT);
+    arguments.addArgument('m', "memory", "search memory limit in MiB", Rubik::ValueType::INT);
+    arguments.addArgument("seed", "random seed", Rubik::ValueType::INT);
+    arguments.addArgument("print", "print solutions", Rubik::ValueType::BOOL);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    int depth = arguments.isSet("depth") ? std::stoi(arguments.getOption("depth")) : 10;
+    int count = arguments.isSet("count") ? std::stoi(arguments.getOption("count")) : 10;
+    uint64_t seed = arguments.isSet("seed") ? std::stoull(arguments.getOption("seed")) : std::time(nullptr);
+
+    if (depth < 0 || depth > 20) {
+        std::cerr << "Scramble length must be within 0 and 20\n";
+        return EXIT_FAILURE;
+    }
+
+    Rubik::BidirectionalSolver solver;
+    if (arguments.isSet("threads")) {
+        solver.setThreads(std::stoi(arguments.getOption("threads")));
+    }
+    if (arguments.isSet("memory")) {
+        solver.setMemory(static_cast<size_t>(std::stoi(arguments.getOption("memory"))) << 20);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    Rubik::Solver twoPhase;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "{\"depth\": " << depth << ", \"seed\": " << seed << ", \"threads\": " << solver.getThreads()
+              << ", \"tables_ms\": " << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << "}\n";
+
+    int failures = 0;
+    for (int index = 0; index < count; index++) {
+        // Never the same or an opposite face back, the optimal solution is then rarely much shorter
+        Rubik::Random random(seed, index);
+        Rubik::CubeState state;
+        int lastFace = -1;
+        for (int turn = 0; turn < depth; turn++) {
+            int face = random.uniform(6);
+            while (face == lastFace || face == (lastFace + 3) % 6) {
+                face = random.uniform(6);
+            }
+
+            state.applyMove(static_cast<Rubik::Move>(face * 3 + random.uniform(3)));
+            lastFace = face;
+        }
+
+        std::vector<Rubik::Move> solution;
+        start = Clock::now();
+        bool solved = solver.solve(state, depth, solution);
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::vector<Rubik::Move> reference;
+        twoPhase.solve(state, Rubik::Solver::MAX_LENGTH, reference);
+
+        Rubik::CubeState check(state);
+        check.applyMoves(solution);
+        solved = solved && check.isSolved() && static_cast<int>(solution.size()) <= depth;
+        failures += solved ? 0 : 1;
+
+        std::cout << "{\"scramble\": " << index << ", \"solved\": " << (solved ? "true" : "false")
+                  << ", \"moves\": " << solution.size() << ", \"two_phase_moves\": " << reference.size()
+                  << ", \"nodes\": " << solver.getNodes() << ", \"ms\": " << elapsed
+                  << ", \"nodes_per_s\": " << (elapsed > 0.0 ? solver.getNodes() * 1000.0 / elapsed : 0.0) << "}\n";
+
+        if (arguments.isSet("print")) {
+            for (auto move: solution) {
+                std::cout << Rubik::MoveName(move) << " ";
+            }
+            std::cout << "\n";
+        }
+    }
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ReductionSolver.h>
+#include <BigCube.h>
+#include <ArgumentParser.h>
+#include <Random.h>
+#include <Config.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+
+// Solves random NxN scrambles with the reduction solver, printing one JSON object per solve.
+// Every solution is checked, the exit status tells whether all of them worked.
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("NxN reduction solver benchmark");
+    arguments.setVersion(RUBIK_VERSION);
+
+    arguments.addArgument('n', "size", "cube size, 7 by default", Rubik::ValueType::INT);
+    arguments.addArgument('c', "count", "scrambles to solve", Rubik::ValueType::INT);
+    arguments.addArgument('t', "threads", "solver threads", Rubik::ValueType::INT);
+    arguments.addArgument("seed", "random seed", Rubik::ValueType::INT);
+    arguments.addArgument("print", "print solutions", Rubik::ValueType::BOOL);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    int size = arguments.isSet("size") ? std::stoi(arguments.getOption("size")) : 7;
+    int count = arguments.isSet("count") ? std::stoi(arguments.getOption("count")) : 10;
+    uint64_t seed = arguments.isSet("seed") ? std::stoull(arguments.getOption("seed")) : std::time(nullptr);
+
+    if (size < Rubik::BigCube::MIN_SIZE || size > Rubik::BigCube::MAX_SIZE) {
+        std::cerr << "Cube size must be within " << Rubik::BigCube::MIN_SIZE << " and " << Rubik::BigCube::MAX_SIZE << "\n";
+        return EXIT_FAILURE;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    Rubik::ReductionSolver solver(size);
+    if (arguments.isSet("threads")) {
+        solver.setThreads(std::stoi(arguments.getOption("threads")));
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "{\"size\": " << size << ", \"seed\": " << seed << ", \"tables_ms\": "
+              << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << "}\n";
+
+    int failures = 0;
+    for (int index = 0; index < count; index++) {
+        // Random layer turns, scrambles long enough to mix every orbit
+        Rubik::Random random(seed, index);
+        Rubik::BigCube cube(size);
+        for (int turn = 0; turn < 20 * size; turn++) {
+            cube.applyMove({
+                static_cast<uint8_t>(random.uniform(3)),
+                static_cast<uint8_t>(random.uniform(size)),
+                static_cast<uint8_t>(random.uniform(3) + 1)
+            });
+        }
+
+        std::vector<Rubik::LayerMove> solution;
+        start = Clock::now();
+        bool solved = solver.solve(cube, solution);
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        cube.applyMoves(solution);
+        solved = solved && cube.isSolved();
+        failures += solved ? 0 : 1;
+
+        std::cout << "{\"scramble\": " << index << ", \"solved\": " << (solved ? "true" : "false")
+                  << ", \"moves\": " << solution.size() << ", \"ms\": " << elapsed << "}\n";
+
+        if (arguments.isSet("print")) {
+            for (auto& move: solution) {
+                std::cout << Rubik::LayerMoveName(size, move) << " ";
+            }
+            std::cout << "\n";
+        }
+    }
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ArgumentParser.h>
+#include <Config.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <thread>
+
+// Pipelines scrambles from stdin to the solver daemon and prints one response per line
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("Solver daemon client, reads one scramble per line");
+    arguments.setVersion(RUBIK_VERSION);
+
+    arguments.addArgument('s', "socket", "solver daemon socket path", Rubik::ValueType::STRING);
+    arguments.addArgument("stats", "print daemon statistics and exit", Rubik::ValueType::BOOL);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    std::string path(arguments.isSet("socket") ? arguments.getOption("socket") : RUBIK_SOCKET);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client == -1 || ::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        std::cerr << "Failed to connect to " << path << ": " << std::strerror(errno) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // A daemon that goes away mid-request must not kill the client with SIGPIPE
+    int sendError = 0;
+    std::thread sender([&arguments, &sendError, client] {
+        auto send = [&sendError, client](const std::string& request) {
+            for (size_t sent = 0; sent < request.size();) {
+                ssize_t written = ::send(client, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+                if (written == -1 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    sendError = (written == -1) ? errno : EPIPE;
+                    return false;
+                }
+                sent += written;
+            }
+            return true;
+        };
+
+        if (arguments.isSet("stats")) {
+            send("STATS\n");
+        } else {
+            std::string line;
+            while (std::getline(std::cin, line) && send("SOLVE " + line + "\n")) {
+            }
+        }
+
+        ::shutdown(client, SHUT_WR);
+    });
+
+    char data[4096];
+    ssize_t size;
+    while ((size = ::recv(client, data, sizeof(data), 0)) > 0) {
+        std::cout.write(data, size);
+    }
+    std::cout.flush();
+
+    sender.join();
+    ::close(client);
+
+    if (sendError != 0) {
+        std::cerr << "Lost connection to " << path << ": " << std::strerror(sendError) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return (size == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2013 Pavlo Lavrenenko
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <TextureFile.h>
+#include <ArgumentParser.h>
+#include <Config.h>
+#include <iostream>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    Rubik::ArgumentParser arguments;
+    arguments.setDescription("Converts a TGA image to a mipmapped texture");
+    arguments.setVersion(RUBIK_VERSION);
+
+    arguments.addArgument('i', "input", "TGA image", Rubik::ValueType::STRING);
+    arguments.addArgument('o', "output", "cooked texture", Rubik::ValueType::STRING);
+
+    if (!arguments.parse(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    if (arguments.isSet("help") || arguments.isSet("version")) {
+        return EXIT_SUCCESS;
+    }
+
+    if (!arguments.isSet("input") || !arguments.isSet("output")) {
+        std::cerr << "Both --input and --output are required\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Rubik::TextureFile texture(Rubik::TextureFile::fromTga(arguments.getOption("input")));
+        texture.generateMipmaps();
+        texture.save(arguments.getOption("output"));
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}